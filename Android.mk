@@ -20,6 +20,11 @@ LOCAL_SRC_FILES := \
 	)
 
 LOCAL_CFLAGS += -std=c++11
+# keep a*b+c rounded twice: the SIMD paths in ImGui match their scalar versions bit for bit
+LOCAL_CFLAGS += -ffp-contract=off
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_ARM_NEON := true
+endif
 LOCAL_EXPORT_LDLIBS := -ldl -llog -landroid
 LOCAL_STATIC_LIBRARIES := android_native_app_glue
 
@@ -16,6 +16,6 @@ win32 {
 }
 
 unix {
-        LIBS += -L$$OUT_PWD/../VBE-Profiler/
+        LIBS += -L$$OUT_PWD/../VBE-Profiler/ -lpthread
         PRE_TARGETDEPS += $$OUT_PWD/../VBE-Profiler/libVBE-Profiler.a
 }
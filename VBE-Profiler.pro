@@ -7,6 +7,7 @@ CONFIG += staticlib
 unix {
     target.path = /usr/lib
     INSTALLS += target
+    QMAKE_CXXFLAGS += -pthread
 }
 
 INCLUDEPATH += include src
@@ -16,6 +17,8 @@ include(../VBE-Scenegraph/VBE-Scenegraph.pri)
 
 LIBS += -lGLEW -lGL -lSDL2
 QMAKE_CXXFLAGS += -std=c++0x -fno-exceptions
+# keep a*b+c rounded twice: the SIMD paths in ImGui match their scalar versions bit for bit
+QMAKE_CXXFLAGS += -ffp-contract=off
 
 OTHER_FILES += \
     VBE-Profiler.pri
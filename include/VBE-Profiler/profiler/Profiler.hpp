@@ -3,48 +3,216 @@
 #include <VBE-Profiler/profiler/imgui.h>
 #include <VBE/VBE.hpp>
 #include <VBE-Scenegraph/VBE-Scenegraph.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #define PROFILER_HIST_SIZE 50
+//16 buckets per power of two of nanoseconds, up to 2^40ns (~18 minutes)
+#define PROFILER_SKETCH_BUCKETS ((40-3)*16)
+//Frames kept by the frame pacing window, binned 4 per power of two from 0.25ms
+//to 256ms, plus one bin below and one above that
+#define PROFILER_PACING_FRAMES 600
+#define PROFILER_PACING_BINS 42
+//Define as a file name to cache the built font atlas there between runs.
+//Off by default: the profiler doesn't write files unless asked to
+#ifndef PROFILER_FONT_CACHE
+#define PROFILER_FONT_CACHE nullptr
+#endif
+//Define when building the profiler to replace the global operator new/delete
+//and count the allocations (ImGui's too) done under each mark
+//#define PROFILER_TRACK_ALLOCATIONS
 
 class DeferredContainer;
 class Profiler : public GameObject {
     public:
+        //Font texture layout a fragment shader samples: ALPHA8 is a single
+        //red channel holding coverage, RGBA32 is white texels with alpha coverage
+        enum AtlasFormat {
+            ALPHA8,
+            RGBA32
+        };
+
+        //How the values a counter gets during a frame make that frame's value
+        enum CounterMode {
+            SUM, //add them up, 0 if none
+            LAST, //keep the latest, carried over to frames without any
+            MAX //keep the highest, 0 if none
+        };
+
+        //What a mark's payload counts, shown as items/ms or MB/s
+        enum PayloadUnit {
+            ITEMS,
+            BYTES
+        };
+
+        //Bytes held by the profiler itself, also shown in the "Profiler Overhead" window
+        struct MemoryUsage {
+                size_t nodes = 0; //marker trees
+                size_t history = 0; //hist entries
+                size_t strings = 0; //per-frame copies (log contents)
+                size_t imguiHeap = 0; //everything ImGui allocated, includes drawLists and fontAtlas
+                size_t drawLists = 0;
+                size_t fontAtlas = 0;
+                size_t fontTexture = 0; //GPU
+                size_t meshBuffers = 0; //GPU, largest draw list uploaded last frame
+        };
+
+        //Log-linear histogram of durations (HDR histogram style) in fixed
+        //memory, quantiles are within ~3%. Counts are cumulative and 64 bit:
+        //merge() adds sketches and subtract() an earlier copy of the same
+        //sketch leaves the durations recorded since, so any window can be
+        //queried. Call sketches are updated once per frame
+        struct Sketch {
+                void add(float ms);
+                void merge(const Sketch& other);
+                void subtract(const Sketch& earlier);
+                float getQuantile(float q) const; //q in [0,1], in ms
+                float getMax() const {return max;}
+                uint64_t getCount() const {return count;}
+            private:
+                static int getBucket(double ns);
+                static double getBucketValue(int bucket);
+
+                uint64_t buckets[PROFILER_SKETCH_BUCKETS] = {};
+                uint64_t count = 0;
+                float max = 0.0f;
+        };
+
         Profiler();
-        Profiler(std::string vertShader, std::string fragShader);
+        Profiler(std::string vertShader, std::string fragShader, AtlasFormat atlasFormat = RGBA32);
         ~Profiler();
 
         static void pushMark(const std::string& name, const std::string& definition);
+        //Also add the work this call does (items processed, bytes copied...)
+        //to the mark, which then shows its throughput next to its time
+        static void pushMark(const std::string& name, const std::string& definition, double payload, PayloadUnit unit = ITEMS);
         static void popMark();
+        //Only pushes while object marks are enabled and a frame tree is open,
+        //returns whether it did. Used by Profiled<T>
+        static bool pushObjectMark(const std::string& type, const std::string& definition);
+        //Time only 1 in oneInN calls of a mark, or 1 in more if timing every
+        //call of the last frame would have cost more than budgetMs. The first
+        //two calls of a frame are always timed and totals are scaled up by
+        //calls/timed calls
+        static void setSampling(const std::string& name, unsigned int oneInN, float budgetMs = 0.0f);
+        //Record a non-time value (entities alive, draw calls, bytes uploaded...)
+        //plotted under the marks in "Frame Times". Samples average the frame
+        //values, or keep the highest one for MAX. A counter keeps the mode it
+        //was first recorded with, values recorded with another one are dropped
+        static void counter(const std::string& name, double value, CounterMode mode = SUM);
+        //Durations of single timed calls and of whole frames of a mark, nullptr
+        //if it never ran
+        static const Sketch* getCallSketch(const std::string& name);
+        static const Sketch* getFrameSketch(const std::string& name);
+        //Allocations per frame done under a mark, its children's included, in
+        //the last sample. False if the mark never ran
+        static bool getAllocations(const std::string& name, float& allocsPerFrame, float& bytesPerFrame);
+        //Attribute an allocation to the open marks. The PROFILER_TRACK_ALLOCATIONS
+        //hooks call it, custom allocators may too
+        static void countAllocation(size_t bytes);
+        //Remove the calibrated cost of nested pushMark/popMark calls from
+        //their parents' times, and their own share from each mark's time
+        static bool isSubtractingOverhead();
+        static void setSubtractOverhead(bool subtract);
+        static bool isObjectMarking();
+        static void setObjectMarking(bool enabled);
+        //Also measure the thread CPU time, context switches and page faults of
+        //timed marks, so time spent descheduled or blocked shows up as waiting.
+        //Linux and Android only, adds two syscalls to each push and pop.
+        //Changes apply from the next frame on and recalibrate the overhead of a mark
+        static bool isCpuTiming();
+        static void setCpuTiming(bool enabled);
         static bool isShown();
         static void setShown(bool shown);
         static bool isLogShown();
         static void setShowLog(bool shown);
         static bool isTimeShown();
         static void setShowTime(bool shown);
+        static bool isMemoryShown();
+        static void setShowMemory(bool shown);
+        static bool isOverheadShown();
+        static void setShowOverhead(bool shown);
+        static bool isPacingShown();
+        static void setShowPacing(bool shown);
+        //Frames longer than this count as over budget in the frame pacing window
+        static float getFrameBudget();
+        static void setFrameBudget(float ms);
+        static MemoryUsage getMemoryUsage();
+        //Route ImGui's allocations through the profiler's pooled allocator and
+        //its stats. Blocks from the default malloc can't be told apart from its
+        //own, so call it before anything allocates through ImGui (before adding
+        //fonts). The constructor tries too, and keeps malloc if it's too late
+        static void installAllocator();
 
     protected:
         virtual void render(const ImDrawData* data) const;
         virtual void renderCustomInterface() const;
 
     private:
+        struct Sampling {
+                unsigned int oneIn = 1;
+                float budget = 0.0f; //seconds per frame, 0 is unlimited
+                unsigned int spread = 1; //1 in how many calls fit the budget last frame
+        };
+
+        //Thread resource usage, or how much of it a span of time used
+        struct CpuSample {
+                static CpuSample now();
+
+                double time = 0.0; //seconds on the CPU
+                double voluntary = 0.0; //context switches, mostly blocking
+                double involuntary = 0.0; //context switches, preemption
+                double faults = 0.0; //page faults
+        };
+
         struct Node {
                 Node() {start();}
                 Node(const std::string& name, const std::string& desc, Node* parent)
                     : parent(parent), name(name), desc(desc) {start();}
                 ~Node() {}
 
-                float getTime() const {return totalTime;}
-                void start() {timeStart = Clock::getSeconds();}
-                void stop() {timeEnd = Clock::getSeconds(); totalTime += timeEnd-timeStart; timeStart = 0.0f;}
+                //estimated from the timed calls when the mark is sampled
+                float getTime() const {return (calls <= samples) ? totalTime : totalTime*calls/samples;}
+                double getTimeVariance() const;
+                unsigned int getCalls() const {return calls;}
+                //what the timed calls' totals are scaled by
+                double getSampleScale() const {return (calls <= samples) ? 1.0 : double(calls)/samples;}
+                //cost of this node's own push/pop pairs as seen by its parent
+                double getOverhead(double timedPair, double untimedPair) const;
+                void start() {timing = true; timeStart = now();}
+                double stop();
+                void enter();
+                void leave();
+                void clearTime();
+                void startCpu();
+                void stopCpu();
+
+                void setTime(double seconds) {totalTime = seconds; timing = false;}
 
                 Node* parent = nullptr;
                 std::list<Node> children;
                 std::string name = std::string("invalid");
                 std::string desc = std::string("invalid");
+                Sampling sampling;
+                Sketch* callSketch = nullptr;
+                double payload = 0.0; //this frame, of every call
+                PayloadUnit payloadUnit = ITEMS;
+                unsigned int allocs = 0; //this frame, children's included
+                size_t allocBytes = 0;
+                CpuSample cpu; //this frame, of the timed calls
+                bool hasCpu = false;
             private:
-                float totalTime = 0.0f;
-                float timeStart = 0.0f;
-                float timeEnd = 0.0f;
+                static double now();
+
+                double totalTime = 0.0;
+                double timeStart = 0.0;
+                bool timing = false;
+                CpuSample cpuStart;
+                bool cpuTiming = false;
+                unsigned int calls = 0;
+                unsigned int samples = 0;
+                double sampleSqSum = 0.0;
         };
 
         class Watcher final : public GameObject {
@@ -58,10 +226,155 @@ class Profiler : public GameObject {
         };
 
         struct Historial final {
-                Historial(unsigned long int id) : id(id) {}
+                Historial(unsigned long int id);
+
+                void push(int offset, float sample);
+                float getMin() const;
+                float getMax() const;
+                float getMean() const;
+                unsigned long int getPushes() const {return pushes;}
+
                 const unsigned long int id = 0;
                 float current = 0.0f;
+                double variance = 0.0; //of current, from sampled marks
+                float confidence = 0.0f; //relative 95% interval of the last sample
+                double payload = 0.0; //of current
+                PayloadUnit payloadUnit = ITEMS;
+                bool hasPayload = false;
+                float payloadPerFrame = 0.0f; //of the last sample
+                float throughput = 0.0f; //of the last sample, per ms or MB/s
+                double allocs = 0.0; //of current
+                double allocBytes = 0.0;
+                float allocsPerFrame = 0.0f; //of the last sample
+                float allocBytesPerFrame = 0.0f;
+                CpuSample cpu; //of current
+                double cpuWall = 0.0; //of current, same calls as cpu and overhead not subtracted
+                CpuSample cpuPerFrame; //of the last sample, time in ms
+                float waitPerFrame = 0.0f; //of the last sample, ms
                 float past[PROFILER_HIST_SIZE];
+                Sketch calls;
+                Sketch frames;
+                //this frame, of every node with this name (a mark can be
+                //pushed under several parents), added to frames at its end
+                double frameTime = 0.0;
+                bool ran = false;
+                //UI labels, only re-formatted when a new sample is pushed
+                mutable unsigned long int labelPushes = 0;
+                mutable char currLabel[32];
+                mutable char scaleLabel[32];
+                mutable char rateLabel[32];
+                mutable char allocLabel[32];
+            private:
+                //monotonic queue entry over the last PROFILER_HIST_SIZE pushes
+                struct Extreme {
+                        unsigned long int seq;
+                        float value;
+                };
+
+                static void pushExtreme(Extreme* queue, int& head, int& count, unsigned long int seq, float value, bool keepGreater);
+
+                unsigned long int pushes = 0;
+                double sum = 0.0;
+                Extreme maxQueue[PROFILER_HIST_SIZE];
+                Extreme minQueue[PROFILER_HIST_SIZE];
+                int maxHead = 0;
+                int maxCount = 0;
+                int minHead = 0;
+                int minCount = 0;
+        };
+
+        struct Counter final {
+                Counter(unsigned long int id, CounterMode mode) : mode(mode), history(id) {}
+
+                const CounterMode mode = SUM;
+                double frame = 0.0; //value so far this frame
+                bool recorded = false; //this frame
+                int frames = 0; //ended since the last sample
+                bool sampled = false; //MAX got a value since the last sample
+                Historial history;
+        };
+
+        //Duration of a timed call, added to its sketch by update()
+        struct TimedCall final {
+                Sketch* sketch;
+                float ms;
+        };
+
+        //Whole frame times of the last PROFILER_PACING_FRAMES frames and the
+        //deltas between consecutive ones, as log scale histograms kept up to
+        //date in O(1) per frame
+        struct Pacing final {
+                void push(float ms, float budget);
+                float getQuantile(const float* bins, float q) const;
+                //"p50 1.23  p95 ..." in ms, the last bin is open-ended
+                void formatQuantiles(const float* bins, char* label, size_t size) const;
+                static int getBin(float ms);
+                static float getBinValue(int bin);
+
+                float durations[PROFILER_PACING_BINS] = {};
+                float deltas[PROFILER_PACING_BINS] = {};
+                int frames = 0;
+                int deltaCount = 0;
+                int overBudget = 0;
+                double deltaSum = 0.0;
+            private:
+                struct Frame {
+                        float delta;
+                        unsigned char duration;
+                        unsigned char deltaBin;
+                        bool hasDelta;
+                        bool overBudget;
+                };
+
+                Frame ring[PROFILER_PACING_FRAMES];
+                int head = 0;
+                float last = -1.0f;
+        };
+
+        //ImGui::MemAlloc/MemFree backend. Small blocks come from size class pools
+        //kept for reuse, scratch memory (ImGuiIO::MemAllocTransientFn) from an
+        //arena recycled every frame, and anything bigger straight from malloc
+        class Allocator final {
+            public:
+                struct FrameStats {
+                        unsigned long int allocs = 0;
+                        unsigned long int frees = 0;
+                        unsigned long int bytes = 0;
+                        unsigned long int transientAllocs = 0;
+                };
+
+                static bool install();
+                static void newFrame();
+
+                static bool installed;
+
+                static FrameStats frame; //last finished frame
+                static size_t liveBytes;
+                static size_t peakBytes;
+                static size_t liveBlocks;
+                static size_t reservedBytes; //pool pages and arena chunks
+                static unsigned int pinnedChunks; //arena chunks held by blocks that outlived their frame
+            private:
+                struct Header;
+                struct Chunk;
+                //size class i hands out blocks of 16<<i bytes carved from 16KB pages
+                struct Pool {
+                        void* freeList;
+                        char* cursor;
+                        char* end;
+                };
+
+                static void* allocate(size_t size);
+                static void* allocateTransient(size_t size);
+                static void release(void* ptr);
+                static void* track(Header* header, size_t size, int sizeClass, Chunk* chunk);
+                static void recycle(Chunk* chunk);
+
+                static FrameStats current;
+                static Pool pools[8];
+                static Chunk* arena;
+                static Chunk* pinned;
+                static Chunk* spare;
         };
 
         static void renderHandle(ImDrawData* data);
@@ -76,16 +389,28 @@ class Profiler : public GameObject {
         void fixedUpdate(float deltaTime) final override;
         void update(float deltaTime) final override;
         void draw() const final override;
-        void processNodeAverage(const Node& n);
+        double processNodeAverage(const Node& n);
+        Historial& getHistorial(const std::string& name);
+        void calibrate();
+        void queueTimedCall(Sketch* sketch, float ms);
         void resetTreeDraw() const;
         void resetTreeUpdate() const;
         void resetTreeFixed() const;
+        void resumeTreeFixed() const;
         void resetTreeSwap() const;
         void resetTreeWhole() const;
         void setImguiIO(float deltaTime) const;
+        void uploadFontGlyphs() const;
         void timeWindow() const;
         void logWindow() const;
+        void memoryWindow() const;
+        void overheadWindow() const;
+        void pacingWindow() const;
+        float getLastSample(const std::string& name) const;
+        static size_t getNodeBytes(const Node& n);
+        static size_t getStringBytes(const std::string& s);
         void uiProcessNode(const Node& n) const;
+        void uiProcessCounter(const std::string& name, const Counter& c) const;
 
         static Profiler* instance;
         static std::string defaultVS;
@@ -95,10 +420,30 @@ class Profiler : public GameObject {
         mutable int frameCount = 0;
         mutable float timePassed = 0.0f;
         mutable int FPS = 0;
+        //fixed steps run this frame, and over the current sample
+        int fixedSteps = 0;
+        int fixedStepsSampled = 0;
+        int fixedStepsPeak = 0;
+        float fixedStepsAvg = 0.0f;
+        int fixedStepsMax = 0;
         bool showProfiler = false;
         bool showTime = true;
         bool showLog = true;
+        bool showMemory = false;
+        bool showOverhead = true;
+        bool showPacing = true;
+        bool objectMarking = false;
+        bool cpuTiming = false;
+        bool cpuTimingNext = false; //set by setCpuTiming, applied at the end of the frame
+        bool subtractOverhead = false;
+        //set while the profiler allocates for itself, countAllocation skips it
+        mutable bool bookkeeping = false;
+        //calibrated in the constructor, in seconds
+        double timedPairCost = 0.0;
+        double untimedPairCost = 0.0;
+        double markInnerCost = 0.0; //what an empty timed mark records
         float sampleRate = 0.5f;
+        float frameBudget = 1000.0f/60.0f; //ms
         float windowAlpha = 0.9f;
         vec2ui wsize = vec2ui(0,0);
         mutable Node treeUpdate;
@@ -108,10 +453,86 @@ class Profiler : public GameObject {
         mutable Node treeWhole;
         mutable Node* currentNode = nullptr;
         std::map<std::string, Historial> hist;
+        std::map<std::string, Sampling> sampling;
+        std::map<std::string, Counter> counters;
+        std::vector<TimedCall> timedCalls; //since the last update(), capacity is kept
+        int heapOffset = 0;
+        float heapAllocs[PROFILER_HIST_SIZE] = {};
+        Pacing pacing;
         mutable MeshIndexed model;
         Texture2D tex;
+        AtlasFormat atlasFormat = RGBA32;
         ShaderProgram program;
         mutable std::string clip = "";
+        mutable size_t logBytes = 0;
+        mutable size_t drawListBytes = 0;
+        mutable size_t meshBytes = 0;
+};
+
+//Times every fixedUpdate, update and draw of T's instances under a mark
+//named after the type, so all objects of a type add up in one node. Opt in
+//per type by creating objects as new Profiled<Enemy>(args...), then turn
+//the marks on with Profiler::setObjectMarking(true).
+//T's overrides of those functions can't be private or final
+template<class T>
+class Profiled final : public T {
+    public:
+        template<typename... Args>
+        Profiled(Args&&... args) : T(std::forward<Args>(args)...) {}
+
+        void fixedUpdate(float deltaTime) override {
+            bool marked = Profiler::pushObjectMark(getType(), getDefinition());
+            T::fixedUpdate(deltaTime);
+            if(marked) Profiler::popMark();
+        }
+
+        void update(float deltaTime) override {
+            bool marked = Profiler::pushObjectMark(getType(), getDefinition());
+            T::update(deltaTime);
+            if(marked) Profiler::popMark();
+        }
+
+        void draw() const override {
+            bool marked = Profiler::pushObjectMark(getType(), getDefinition());
+            T::draw();
+            if(marked) Profiler::popMark();
+        }
+
+    private:
+        //type name taken from this function's signature, no RTTI needed
+        static const std::string& getType() {
+#ifdef _MSC_VER
+            static const std::string type = parseType(__FUNCSIG__);
+#else
+            static const std::string type = parseType(__PRETTY_FUNCTION__);
+#endif
+            return type;
+        }
+
+        static const std::string& getDefinition() {
+            static const std::string definition = "Time spent in objects of type " + getType();
+            return definition;
+        }
+
+        static std::string parseType(const std::string& signature) {
+#ifdef _MSC_VER
+            //"... Profiled<class Enemy>::getType(void)"
+            size_t begin = signature.find("Profiled<") + 9;
+            size_t end = begin;
+            for(int depth = 0; end < signature.size() && (depth > 0 || signature[end] != '>'); ++end)
+                depth += (signature[end] == '<') - (signature[end] == '>');
+            std::string type = signature.substr(begin, end - begin);
+            const char* keywords[] = {"class ", "struct "};
+            for(const char* keyword : keywords)
+                for(size_t pos; (pos = type.find(keyword)) != std::string::npos;)
+                    type.erase(pos, std::char_traits<char>::length(keyword));
+            return type;
+#else
+            //"... [with T = Enemy; ...]" on GCC, "... [T = Enemy]" on clang
+            size_t begin = signature.find("T = ") + 4;
+            return signature.substr(begin, signature.find_first_of(";]", begin) - begin);
+#endif
+        }
 };
 
 #endif // PROFILER_HPP
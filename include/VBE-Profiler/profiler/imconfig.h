@@ -35,6 +35,15 @@
 //---- Pack colors to BGRA instead of RGBA (remove need to post process vertex buffer in back ends)
 //#define IMGUI_USE_BGRA_PACKED_COLOR
 
+//---- Don't use the SSE2/NEON code paths (plot decimation, etc.) even when the target supports them
+//#define IMGUI_DISABLE_SIMD
+
+//---- Don't rasterize large font atlases on worker threads (avoids depending on <thread>)
+//#define IMGUI_DISABLE_FONT_BUILD_THREADS
+
+//---- Hash IDs with CRC32C instead of CRC32, using the SSE4.2/ARMv8 CRC instructions when the target has them. IDs differ from regular builds.
+//#define IMGUI_USE_CRC32C_HASH
+
 //---- Implement STB libraries in a namespace to avoid linkage conflicts
 //#define IMGUI_STB_NAMESPACE     ImGuiStb
 
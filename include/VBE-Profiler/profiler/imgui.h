@@ -784,6 +784,7 @@ struct ImGuiStyle
     ImVec2      DisplaySafeAreaPadding;     // If you cannot see the edge of your screen (e.g. on a TV) increase the safe area padding. Covers popups/tooltips as well regular windows.
     bool        AntiAliasedLines;           // Enable anti-aliasing on lines/borders. Disable if you are really tight on CPU/GPU.
     bool        AntiAliasedShapes;          // Enable anti-aliasing on filled shapes (rounded rectangles, circles, etc.)
+    bool        JoinedLines;                // Share vertices between consecutive segments of non anti-aliased lines (mitered joins, split at corners sharper than 90 degrees), roughly halving their vertex count. Disable to get one quad per segment.
     float       CurveTessellationTol;       // Tessellation tolerance. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
     ImVec4      Colors[ImGuiCol_COUNT];
 
@@ -843,6 +844,7 @@ struct ImGuiIO
     // (default to posix malloc/free)
     void*       (*MemAllocFn)(size_t sz);
     void        (*MemFreeFn)(void* ptr);
+    void*       (*MemAllocTransientFn)(size_t sz);  // Scratch memory that is freed soon after (glyph rasterization, clipboard filtering), released with MemFreeFn(). NULL uses MemAllocFn()
 
     // Optional: notify OS Input Method Editor of the screen position of your cursor for text input position (e.g. when using Japanese/Chinese IME in Windows)
     // (default to use native imm32 api on Windows)
@@ -1073,12 +1075,15 @@ struct ImGuiStorage
         Pair(ImGuiID _key, float _val_f) { key = _key; val_f = _val_f; }
         Pair(ImGuiID _key, void* _val_p) { key = _key; val_p = _val_p; }
     };
-    ImVector<Pair>      Data;
+    ImVector<Pair>      Data;           // Pairs in insertion order (sorted by key after BuildSortByKey())
+    ImVector<int>       Index;          // [Internal] Open addressing hash table of Data indices + 1 (0 = empty slot)
+    int                 IndexedCount;   // [Internal] Data.Size when Index was last updated, lookups fall back to a linear search while pairs appended directly are not indexed
 
-    // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N)
+    // - Get***() functions find pair, never add/allocate. Pairs are hashed so a query is O(1)
     // - Set***() functions find pair, insertion on demand if missing.
-    // - Sorted insertion is costly, paid once. A typical frame shouldn't need to insert any new pair.
-    void                Clear() { Data.clear(); }
+    // - Insertion appends to Data and is amortized O(1), the index is rebuilt when it grows past half full.
+    ImGuiStorage()      { IndexedCount = 0; }
+    void                Clear() { Data.clear(); Index.clear(); IndexedCount = 0; }
     IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
     IMGUI_API void      SetInt(ImGuiID key, int val);
     IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
@@ -1100,7 +1105,8 @@ struct ImGuiStorage
     // Use on your own storage if you know only integer are being stored (open/close all tree nodes)
     IMGUI_API void      SetAllInt(int val);
 
-    // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
+    // For quicker full rebuild of a storage (instead of an incremental one), you may push_back() all your contents into Data and then sort and index them once.
+    // Call it as well after removing pairs from Data or changing their keys directly, only appended pairs are noticed without it.
     IMGUI_API void      BuildSortByKey();
 };
 
@@ -1448,6 +1454,18 @@ struct ImFontAtlas
     IMGUI_API void              GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 4 bytes-per-pixel
     void                        SetTexID(ImTextureID id)    { TexID = id; }
 
+    // Save/load the built atlas (alpha8 pixels, font metrics and glyph tables) so startup can skip TTF decompression, rasterization and packing.
+    // Add your fonts before loading (Build() would add the default font if there are none): the data carries a hash of every font input (data, size, ranges,
+    // oversampling...) and is rejected unless it matches the fonts added and the ImGui version. Loading replaces them with the built fonts and keeps no input data.
+    IMGUI_API bool              SaveBuiltData(const char* filename) const;                  // Call after Build() or GetTexData*()
+    IMGUI_API bool              LoadBuiltData(const char* filename);                        // Single file read. Returns false (and leaves the atlas untouched) if missing or invalid
+    IMGUI_API bool              LoadBuiltDataFromMemory(const void* data, int data_size);   // e.g. from a blob generated at build time
+
+    // Dynamic atlas (DynamicGlyphs = true before building): Build() only measures glyphs, each one is rasterized into the texture the first time it is drawn.
+    // After rendering a frame, re-upload the rectangle returned by GetTexDirtyRect() (if any) to your texture and call ClearTexDirtyRect().
+    IMGUI_API bool              GetTexDirtyRect(int* out_x, int* out_y, int* out_w, int* out_h) const; // Returns false if no pixels changed since the last ClearTexDirtyRect()
+    void                        ClearTexDirtyRect()         { TexDirtyX0 = TexDirtyY0 = TexDirtyX1 = TexDirtyY1 = 0; }
+
     //-------------------------------------------
     // Glyph Ranges
     //-------------------------------------------
@@ -1504,6 +1522,8 @@ struct ImFontAtlas
     ImTextureID                 TexID;              // User data to refer to the texture once it has been uploaded to user's graphic systems. It is passed back to you during rendering via the ImDrawCmd structure.
     int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
     int                         TexGlyphPadding;    // Padding between glyphs within texture in pixels. Defaults to 1.
+    int                         BuildThreadsCount;  // Threads rasterizing glyphs during Build() when there are thousands of them (e.g. CJK ranges). Defaults to 0 (one per hardware thread), 1 to stay on the calling thread.
+    bool                        DynamicGlyphs;      // Rasterize glyphs on first use into a fixed size texture (TexDesiredWidth squared) instead of during Build(). Glyphs that don't fit use the fallback glyph. Defaults to false.
 
     // [Internal]
     // NB: Access texture data via GetTexData*() calls! Which will setup a default font for you.
@@ -1516,6 +1536,42 @@ struct ImFontAtlas
     ImVector<CustomRect>        CustomRects;        // Rectangles for packing custom texture data into the atlas.
     ImVector<ImFontConfig>      ConfigData;         // Internal data
     int                         CustomRectIds[1];   // Identifiers of custom texture rectangle used by ImFontAtlas/ImDrawList
+    int                         TexDirtyX0, TexDirtyY0, TexDirtyX1, TexDirtyY1; // Texture area rasterized into since the last ClearTexDirtyRect() (DynamicGlyphs only)
+    void*                       DynamicBuildData;   // Font info and pack context kept alive to rasterize glyphs on demand (DynamicGlyphs only)
+};
+
+// Size and glyph quads of strings measured/drawn over and over (labels, tree nodes), keyed by contents and font size.
+// The pen advances are kept per glyph and replayed from the text position, so the vertices match the regular RenderText() path exactly.
+// A string is only cached the second time it is seen in a short while, so text changing every frame (e.g. formatted values) doesn't churn the cache.
+struct ImFontLayoutCache
+{
+    enum QuadKind { QuadKind_Glyph, QuadKind_Blank, QuadKind_NewLine };
+    struct Quad
+    {
+        float           X0, Y0, X1, Y1;         // Unscaled glyph corners, relative to the pen
+        float           U0, V0, U1, V1;
+        float           AdvanceX;               // Unscaled
+        int             Kind;                   // QuadKind_
+    };
+    struct Entry
+    {
+        float           Size;
+        int             TextOffset, TextLen;    // In Text
+        ImVec2          TextSize;               // CalcTextSizeA() result, x < 0.0f until measured
+        int             QuadOffset, QuadCount;  // In Quads, glyphs and the blanks/line breaks between them. QuadCount < 0 until laid out
+        int             GlyphCount;             // Quads with vertices
+        float           Scale, LineHeight;      // Computed like RenderText() does
+    };
+
+    ImGuiStorage        Map;                    // Hash -> index+1 in Entries
+    ImVector<Entry>     Entries;
+    ImVector<char>      Text;
+    ImVector<Quad>      Quads;
+    ImGuiID             Seen[2048];             // Hashes seen once, by hash modulo size
+    bool                Stale;                  // Glyph advances changed, clear before next use
+
+    ImFontLayoutCache()                         { memset(Seen, 0, sizeof(Seen)); Stale = false; }
+    IMGUI_API void      Clear();
 };
 
 // Font runtime data and rendering
@@ -1539,6 +1595,7 @@ struct ImFont
     ImFontAtlas*                ContainerAtlas;     //              // What we has been loaded into
     float                       Ascent, Descent;    //              // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize]
     int                         MetricsTotalSurface;//              // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
+    mutable ImFontLayoutCache   LayoutCache;        //              // Used by CalcTextSizeA()/RenderText() for unwrapped text
 
     // Methods
     IMGUI_API ImFont();
@@ -15,6 +15,15 @@
 #include <stdio.h>      // FILE*
 #include <math.h>       // sqrtf, fabsf, fmodf, powf, floorf, ceilf, cosf, sinf
 
+// SIMD code paths: SSE2 on x86/x64, NEON on ARM. Define IMGUI_DISABLE_SIMD in imconfig.h to force the scalar versions.
+#if !defined(IMGUI_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_ENABLE_SSE2
+#include <emmintrin.h>
+#elif !defined(IMGUI_DISABLE_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define IMGUI_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+
 #ifdef _MSC_VER
 #pragma warning (push)
 #pragma warning (disable: 4251) // class 'xxx' needs to have dll-interface to be used by clients of struct 'xxx' // when IMGUI_API is set to__declspec(dllexport)
@@ -86,9 +95,11 @@ IMGUI_API int           ImTextCharFromUtf8(unsigned int* out_char, const char* i
 IMGUI_API int           ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char* in_text, const char* in_text_end, const char** in_remaining = NULL);   // return input UTF-8 bytes count
 IMGUI_API int           ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end);                            // return number of UTF-8 code-points (NOT bytes count)
 IMGUI_API int           ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_end);                   // return number of bytes to express string as UTF-8 code-points
+IMGUI_API const char*   ImTextSkipPrintableAscii(const char* in_text, const char* in_text_end);                            // return end of the run of printable ASCII characters [32..127] starting at in_text
 
 // Helpers: Misc
 IMGUI_API ImU32         ImHash(const void* data, int data_size, ImU32 seed = 0);    // Pass data_size==0 for zero-terminated strings
+IMGUI_API void          ImMinMax(const float* values, int values_count, float* out_min, float* out_max); // SIMD when available, values_count must be > 0
 IMGUI_API void*         ImFileLoadToMemory(const char* filename, const char* file_open_mode, int* out_file_size = NULL, int padding_bytes = 0);
 IMGUI_API FILE*         ImFileOpen(const char* filename, const char* file_open_mode);
 static inline bool      ImCharIsSpace(int c)            { return c == ' ' || c == '\t' || c == 0x3000; }
@@ -801,6 +812,7 @@ namespace ImGui
     IMGUI_API void          FocusWindow(ImGuiWindow* window);
     IMGUI_API void          BringWindowToFront(ImGuiWindow* window);
     IMGUI_API void          BringWindowToBack(ImGuiWindow* window);
+    IMGUI_API void*         MemAllocTransient(size_t sz);   // Scratch memory, see IO.MemAllocTransientFn. Free with MemFree()
 
     IMGUI_API void          Initialize();
 
@@ -905,6 +917,9 @@ IMGUI_API void              ImFontAtlasBuildRegisterDefaultCustomRects(ImFontAtl
 IMGUI_API void              ImFontAtlasBuildSetupFont(ImFontAtlas* atlas, ImFont* font, ImFontConfig* font_config, float ascent, float descent); 
 IMGUI_API void              ImFontAtlasBuildPackCustomRects(ImFontAtlas* atlas, void* spc);
 IMGUI_API void              ImFontAtlasBuildFinish(ImFontAtlas* atlas);
+IMGUI_API void              ImFontAtlasBuildSetupDefaultTexData(ImFontAtlas* atlas);
+IMGUI_API void              ImFontAtlasBuildDynamicRegisterGlyphs(ImFontAtlas* atlas, ImFont* font);
+IMGUI_API const ImFontGlyph*ImFontAtlasBuildDynamicGlyph(ImFontAtlas* atlas, ImFont* font, ImWchar codepoint);
 IMGUI_API void              ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_multiply_factor);
 IMGUI_API void              ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsigned char* pixels, int x, int y, int w, int h, int stride);
 
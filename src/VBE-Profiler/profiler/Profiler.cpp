@@ -1,6 +1,130 @@
 #include <VBE-Profiler/profiler/Profiler.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <iomanip>
+#include <limits>
+#include <new>
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#ifdef PROFILER_TRACK_ALLOCATIONS
+//only allocations from the thread that pushes marks are attributed
+static thread_local bool markThread = false;
+
+//The replacements allocate with malloc and free with free on purpose, GCC
+//sees them inlined into the container code below and warns about the pairing
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    Profiler::countAllocation(size);
+    void* ptr = malloc(size ? size : 1);
+    if(ptr == nullptr) abort(); //no exceptions to throw std::bad_alloc
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    Profiler::countAllocation(size);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, std::size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    free(ptr);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+//over-aligned types (C++17), posix_memalign memory is released with free too
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    Profiler::countAllocation(size);
+    void* ptr = nullptr;
+    const std::size_t alignment = std::max(std::size_t(align), sizeof(void*));
+    if(posix_memalign(&ptr, alignment, size ? size : 1) != 0) return nullptr;
+    return ptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* ptr = operator new(size, align, std::nothrow);
+    if(ptr == nullptr) abort(); //no exceptions to throw std::bad_alloc
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return operator new(size, align, std::nothrow);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    free(ptr);
+}
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define ALLOCATOR_ALIGN 16
+#define ALLOCATOR_PAGE_SIZE (16*1024)
+#define ALLOCATOR_CHUNK_SIZE (64*1024)
 
 Profiler* Profiler::instance = nullptr;
 std::string Profiler::defaultVS = " \
@@ -30,26 +154,20 @@ std::string Profiler::defaultFS = " \
     out vec4 finalColor;\
     \
     void main(void) { \
-        finalColor = vec4(texture(fontTex,vTexCoord)*vColor); \
+        finalColor = vec4(vColor.rgb, vColor.a*texture(fontTex,vTexCoord).r); \
     }";
 
-namespace {
-    std::string toString(float f, int width, int precision, bool left) {
-        std::ostringstream temp;
-        if(left) temp << std::left;
-        temp << std::fixed << std::setprecision(precision) << std::setw(width) << f;
-        return temp.str();
-    }
-}
-
-Profiler::Profiler() : Profiler(defaultVS, defaultFS) {
+Profiler::Profiler() : Profiler(defaultVS, defaultFS, ALPHA8) {
 }
 
-Profiler::Profiler(std::string vertShader, std::string fragShader) {
+Profiler::Profiler(std::string vertShader, std::string fragShader, AtlasFormat atlasFormat) : atlasFormat(atlasFormat) {
     //setup singleton
     VBE_ASSERT(instance == nullptr, "Created two profilers");
     instance = this;
 
+    //only works if nothing allocated through ImGui yet
+    Allocator::install();
+
     // Pick program
     program = ShaderProgram(vertShader, fragShader);
 
@@ -78,16 +196,32 @@ Profiler::Profiler(std::string vertShader, std::string fragShader) {
     io.IniSavingRate = -1.0f; //disable ini
     io.ClipboardUserData = NULL;
 
-    // Build texture atlas
+    // Build texture atlas, or load it if PROFILER_FONT_CACHE is set and a previous run cached it.
+    // Setting io.Fonts->DynamicGlyphs before creating the profiler skips the
+    // cache and rasterizes glyphs the first time they are drawn instead
     unsigned char* pixels;
     int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-    tex = Texture2D(vec2ui(width, height), TextureFormat::RGBA);
+    const char* fontCache = PROFILER_FONT_CACHE;
+    //the cache only matches the fonts it was built from, add the one Build() would
+    if(fontCache != nullptr && io.Fonts->ConfigData.empty()) io.Fonts->AddFontDefault();
+    bool cachedFonts = io.Fonts->LoadBuiltData(fontCache);
+    if(atlasFormat == ALPHA8) io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    else io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    if(!cachedFonts) io.Fonts->SaveBuiltData(fontCache);
+    TextureFormat::Format texFormat = (atlasFormat == ALPHA8) ? TextureFormat::RED : TextureFormat::RGBA;
+    tex = Texture2D(vec2ui(width, height), texFormat);
     tex.setFilter(GL_LINEAR, GL_LINEAR);
-    tex.setData(pixels, TextureFormat::RGBA, TextureFormat::UNSIGNED_BYTE);
+    tex.setData(pixels, texFormat, TextureFormat::UNSIGNED_BYTE);
     //glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     io.Fonts->TexID = (void *)(intptr_t)tex.getHandle();
 
+#ifdef PROFILER_TRACK_ALLOCATIONS
+    markThread = true;
+#endif
+    calibrate();
+    resetTreeWhole();
+    currentNode = nullptr;
+
     //add watcher
     Watcher* w = new Watcher();
     w->addTo(this);
@@ -104,23 +238,148 @@ void Profiler::pushMark(const std::string& name, const std::string& definition)
     VBE_ASSERT(instance->currentNode != nullptr, "Popped main node on profiler");
     for(Node& child : instance->currentNode->children) {
         if(child.name == name) {
-            child.start();
+            child.enter();
+            if(instance->cpuTiming) child.startCpu();
             instance->currentNode = &child;
             return;
         }
     }
+    //a new node and its history aren't the marked code's allocations
+    const bool wasBookkeeping = instance->bookkeeping;
+    instance->bookkeeping = true;
     instance->currentNode->children.push_back(Node(name,definition, instance->currentNode));
-    instance->currentNode = &instance->currentNode->children.back();
+    Node& child = instance->currentNode->children.back();
+    auto policy = instance->sampling.find(name);
+    if(policy != instance->sampling.end()) {
+        child.sampling = policy->second;
+        child.sampling.oneIn = std::max(policy->second.oneIn, policy->second.spread);
+    }
+    child.callSketch = &instance->getHistorial(name).calls;
+    instance->bookkeeping = wasBookkeeping;
+    child.enter();
+    if(instance->cpuTiming) child.startCpu();
+    instance->currentNode = &child;
+}
+
+//static
+void Profiler::pushMark(const std::string& name, const std::string& definition, double payload, PayloadUnit unit) {
+    pushMark(name, definition);
+    instance->currentNode->payload += payload;
+    instance->currentNode->payloadUnit = unit;
 }
 
 //static
 void Profiler::popMark() {
     VBE_ASSERT(instance != nullptr, "Null profiler");
     VBE_ASSERT(instance->currentNode != nullptr, "Too many popped nodes on profiler");
-    instance->currentNode->stop();
+    instance->currentNode->stopCpu();
+    instance->currentNode->leave();
     instance->currentNode = instance->currentNode->parent;
 }
 
+//static
+void Profiler::setSampling(const std::string& name, unsigned int oneInN, float budgetMs) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    VBE_ASSERT(oneInN > 0, "Sampling 1 in 0 calls");
+    Sampling& policy = instance->sampling[name];
+    policy.oneIn = oneInN;
+    policy.budget = budgetMs/1000.0f;
+}
+
+//static
+void Profiler::counter(const std::string& name, double value, CounterMode mode) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    auto it = instance->counters.find(name);
+    if(it == instance->counters.end())
+        it = instance->counters.insert(std::pair<std::string, Counter>(name, Counter(instance->counters.size(), mode))).first;
+    Counter& c = it->second;
+    VBE_ASSERT(c.mode == mode, "Counter recorded with a different mode");
+    if(c.mode != mode) return;
+    if(mode == SUM) c.frame += value;
+    else if(mode == LAST || !c.recorded) c.frame = value;
+    else c.frame = std::max(c.frame, value);
+    c.recorded = true;
+}
+
+//static
+bool Profiler::pushObjectMark(const std::string& type, const std::string& definition) {
+    //no tree is open before the first frame, or between the fixed steps and the update
+    if(instance == nullptr || !instance->objectMarking || instance->currentNode == nullptr)
+        return false;
+    pushMark(type, definition);
+    return true;
+}
+
+//static
+bool Profiler::isObjectMarking() {
+    return (instance != nullptr && instance->objectMarking);
+}
+
+//static
+void Profiler::setObjectMarking(bool enabled) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    instance->objectMarking = enabled;
+}
+
+//static
+const Profiler::Sketch* Profiler::getCallSketch(const std::string& name) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    auto it = instance->hist.find(name);
+    return (it == instance->hist.end()) ? nullptr : &it->second.calls;
+}
+
+//static
+const Profiler::Sketch* Profiler::getFrameSketch(const std::string& name) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    auto it = instance->hist.find(name);
+    return (it == instance->hist.end()) ? nullptr : &it->second.frames;
+}
+
+//static
+bool Profiler::isCpuTiming() {
+    return (instance != nullptr && instance->cpuTimingNext);
+}
+
+//static
+void Profiler::setCpuTiming(bool enabled) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    //applied between frames by update(), which recalibrates
+    instance->cpuTimingNext = enabled;
+}
+
+//static
+bool Profiler::getAllocations(const std::string& name, float& allocsPerFrame, float& bytesPerFrame) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    auto it = instance->hist.find(name);
+    if(it == instance->hist.end()) return false;
+    allocsPerFrame = it->second.allocsPerFrame;
+    bytesPerFrame = it->second.allocBytesPerFrame;
+    return true;
+}
+
+//static
+void Profiler::countAllocation(size_t bytes) {
+#ifdef PROFILER_TRACK_ALLOCATIONS
+    if(!markThread) return;
+#endif
+    if(instance == nullptr || instance->bookkeeping) return;
+    for(Node* n = instance->currentNode; n != nullptr; n = n->parent) {
+        ++n->allocs;
+        n->allocBytes += bytes;
+    }
+}
+
+//static
+bool Profiler::isSubtractingOverhead() {
+    return (instance != nullptr && instance->subtractOverhead);
+}
+
+//static
+void Profiler::setSubtractOverhead(bool subtract) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    instance->subtractOverhead = subtract;
+}
+
 //static
 void Profiler::setShown(bool shown) {
     VBE_ASSERT(instance != nullptr, "Null profiler");
@@ -149,12 +408,90 @@ void Profiler::setShowTime(bool shown) {
     instance->showTime = shown;
 }
 
+//static
+bool Profiler::isMemoryShown() {
+    return (isShown() && instance->showMemory);
+}
+
+//static
+void Profiler::setShowMemory(bool shown) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    instance->showMemory = shown;
+}
+
+//static
+bool Profiler::isOverheadShown() {
+    return (isShown() && instance->showOverhead);
+}
+
+//static
+void Profiler::setShowOverhead(bool shown) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    instance->showOverhead = shown;
+}
+
+//static
+bool Profiler::isPacingShown() {
+    return (isShown() && instance->showPacing);
+}
+
+//static
+void Profiler::setShowPacing(bool shown) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    instance->showPacing = shown;
+}
+
+//static
+float Profiler::getFrameBudget() {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    return instance->frameBudget;
+}
+
+//static
+void Profiler::setFrameBudget(float ms) {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    VBE_ASSERT(ms > 0.0f, "Frame budget must be positive");
+    instance->frameBudget = ms;
+}
+
+//static
+void Profiler::installAllocator() {
+    bool installed = Allocator::install();
+    VBE_ASSERT(installed, "ImGui allocated memory before installing the profiler allocator");
+    (void) installed;
+}
+
+//static
+Profiler::MemoryUsage Profiler::getMemoryUsage() {
+    VBE_ASSERT(instance != nullptr, "Null profiler");
+    MemoryUsage usage;
+    const Node* trees[] = {&instance->treeWhole, &instance->treeFixed, &instance->treeUpdate, &instance->treeDraw, &instance->treeSwap};
+    for(const Node* tree : trees)
+        usage.nodes += getNodeBytes(*tree) - sizeof(Node); //roots are members
+    //map nodes carry a color and three links besides the value
+    for(const auto& entry : instance->hist)
+        usage.history += sizeof(entry) + 4*sizeof(void*) + getStringBytes(entry.first);
+    for(const auto& entry : instance->counters)
+        usage.history += sizeof(entry) + 4*sizeof(void*) + getStringBytes(entry.first);
+    usage.history += instance->timedCalls.capacity()*sizeof(TimedCall);
+    usage.strings = instance->logBytes + getStringBytes(instance->clip);
+    usage.imguiHeap = Allocator::liveBytes;
+    usage.drawLists = instance->drawListBytes;
+    const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    const size_t texels = size_t(atlas->TexWidth)*atlas->TexHeight;
+    usage.fontAtlas = (atlas->TexPixelsAlpha8 ? texels : 0) + (atlas->TexPixelsRGBA32 ? texels*4 : 0);
+    usage.fontTexture = texels*(instance->atlasFormat == ALPHA8 ? 1 : 4);
+    usage.meshBuffers = instance->meshBytes;
+    return usage;
+}
+
 //static
 bool Profiler::isShown() {
     return (instance != nullptr && instance->showProfiler);
 }
 
 void Profiler::renderHandle(ImDrawData* data) {
+    instance->uploadFontGlyphs();
     instance->render(data);
 }
 
@@ -168,7 +505,41 @@ void Profiler::setClipHandle(void* user_data, const char* text) {
     instance->setClip(text);
 }
 
+void Profiler::uploadFontGlyphs() const {
+    //only dynamic atlases rasterize glyphs after the texture is created
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    int x, y, w, h;
+    if(!atlas->GetTexDirtyRect(&x, &y, &w, &h))
+        return;
+    unsigned char* pixels;
+    int width, height;
+    if(atlasFormat == ALPHA8) atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+    else atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    const int bytesPerPixel = (atlasFormat == ALPHA8) ? 1 : 4;
+
+    //upload just the changed rectangle, leaving the GL binding state as we found it
+    GLint prevTex, prevAlignment, prevRowLength;
+    GL_ASSERT(glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTex));
+    GL_ASSERT(glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment));
+    GL_ASSERT(glGetIntegerv(GL_UNPACK_ROW_LENGTH, &prevRowLength));
+    GL_ASSERT(glBindTexture(GL_TEXTURE_2D, tex.getHandle()));
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ROW_LENGTH, width));
+    GL_ASSERT(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, (atlasFormat == ALPHA8) ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, pixels + (y*width + x)*bytesPerPixel));
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ROW_LENGTH, prevRowLength));
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment));
+    GL_ASSERT(glBindTexture(GL_TEXTURE_2D, prevTex));
+    atlas->ClearTexDirtyRect();
+}
+
 void Profiler::render(const ImDrawData* drawData) const {
+    drawListBytes = 0;
+    meshBytes = 0;
+    for (int n = 0; n < drawData->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[n];
+        drawListBytes += cmd_list->VtxBuffer.Capacity*sizeof(ImDrawVert) + cmd_list->IdxBuffer.Capacity*sizeof(ImDrawIdx) + cmd_list->CmdBuffer.Capacity*sizeof(ImDrawCmd);
+        meshBytes = std::max(meshBytes, cmd_list->VtxBuffer.Size*sizeof(ImDrawVert) + cmd_list->IdxBuffer.Size*sizeof(ImDrawIdx));
+    }
     if (drawData->CmdListsCount == 0)
         return;
 
@@ -223,21 +594,98 @@ void Profiler::fixedUpdate(float deltaTime) {
 
 void Profiler::update(float deltaTime) {
     popMark(); //update
+    //histories, trees and the profiler's own ImGui frame
+    bookkeeping = true;
     treeWhole.stop();
-    processNodeAverage(treeSwap);
-    processNodeAverage(treeDraw);
-    processNodeAverage(treeFixed);
-    processNodeAverage(treeUpdate);
+    double overhead = processNodeAverage(treeSwap);
+    overhead += processNodeAverage(treeDraw);
+    overhead += processNodeAverage(treeFixed);
+    overhead += processNodeAverage(treeUpdate);
+    treeWhole.children.front().setTime(overhead); //"Measurement overhead"
+    //the other trees aren't children of the whole frame
+    const Node* trees[] = {&treeSwap, &treeDraw, &treeFixed, &treeUpdate};
+    for(const Node* tree : trees) {
+        treeWhole.allocs += tree->allocs;
+        treeWhole.allocBytes += tree->allocBytes;
+    }
     processNodeAverage(treeWhole);
+    for(const TimedCall& call : timedCalls)
+        call.sketch->add(call.ms);
+    timedCalls.clear();
+    for(auto it = hist.begin(); it != hist.end(); ++it) {
+        //one value per frame, the total of every node with the name
+        if(it->second.ran) it->second.frames.add(float(it->second.frameTime*1000));
+        it->second.frameTime = 0.0;
+        it->second.ran = false;
+    }
+    pacing.push(treeWhole.getTime()*1000, frameBudget);
+    for(auto it = counters.begin(); it != counters.end(); ++it) {
+        Counter& c = it->second;
+        if(c.mode != MAX) c.history.current += float(c.frame);
+        else if(c.recorded) {
+            //seeded with the first value, counters may be negative
+            c.history.current = c.sampled ? std::max(c.history.current, float(c.frame)) : float(c.frame);
+            c.sampled = true;
+        }
+        if(c.mode != LAST) c.frame = 0.0;
+        c.recorded = false;
+        ++c.frames;
+    }
+    //every fixed step of this frame accumulated into treeFixed. Keep its
+    //structure for the UI but don't count it again if next frame has no steps
+    treeFixed.clearTime();
+    fixedStepsSampled += fixedSteps;
+    fixedStepsPeak = std::max(fixedStepsPeak, fixedSteps);
+    fixedSteps = 0;
+    if(cpuTiming != cpuTimingNext) {
+        //the CPU syscalls are part of every timed pair now, or no longer are.
+        //No tree is open and the next frame isn't being timed yet
+        cpuTiming = cpuTimingNext;
+        calibrate();
+    }
     resetTreeWhole();
     pushMark("Profiler Prepare", "Time spent preparing the profiler geometry");
     if(timePassed >= sampleRate) {
         //update history
         timeAvgOffset = (timeAvgOffset + 1) % PROFILER_HIST_SIZE;
         for(auto it = hist.begin(); it != hist.end(); ++it) {
-            it->second.past[timeAvgOffset] = (it->second.current/frameCount)*1000;
+            it->second.confidence = (it->second.current > 0.0f) ? float(1.96*std::sqrt(it->second.variance)/it->second.current) : 0.0f;
+            if(it->second.hasPayload) {
+                //current is in seconds
+                const double perSecond = (it->second.current > 0.0f) ? it->second.payload/it->second.current : 0.0;
+                it->second.payloadPerFrame = float(it->second.payload/frameCount);
+                it->second.throughput = float((it->second.payloadUnit == BYTES) ? perSecond/(1024*1024) : perSecond/1000);
+                it->second.payload = 0.0;
+            }
+            it->second.allocsPerFrame = float(it->second.allocs/frameCount);
+            it->second.allocBytesPerFrame = float(it->second.allocBytes/frameCount);
+            it->second.allocs = it->second.allocBytes = 0.0;
+            CpuSample& perFrame = it->second.cpuPerFrame;
+            const CpuSample& cpu = it->second.cpu;
+            perFrame.time = cpu.time/frameCount*1000;
+            perFrame.voluntary = cpu.voluntary/frameCount;
+            perFrame.involuntary = cpu.involuntary/frameCount;
+            perFrame.faults = cpu.faults/frameCount;
+            it->second.waitPerFrame = float(std::max(0.0, it->second.cpuWall - cpu.time)/frameCount*1000);
+            it->second.cpu = CpuSample();
+            it->second.cpuWall = 0.0;
+            it->second.push(timeAvgOffset, (it->second.current/frameCount)*1000);
             it->second.current = 0.0f;
+            it->second.variance = 0.0;
         }
+        for(auto it = counters.begin(); it != counters.end(); ++it) {
+            //counters created during this sample only average their own frames
+            Counter& c = it->second;
+            c.history.push(timeAvgOffset, (c.mode == MAX || c.frames == 0) ? c.history.current : c.history.current/c.frames);
+            c.history.current = 0.0f;
+            c.frames = 0;
+            c.sampled = false;
+        }
+        //update fixed step counts
+        fixedStepsAvg = float(fixedStepsSampled)/frameCount;
+        fixedStepsMax = fixedStepsPeak;
+        fixedStepsSampled = 0;
+        fixedStepsPeak = 0;
         //update FPS
         timePassed -= sampleRate;
         FPS = float(frameCount)/sampleRate;
@@ -249,6 +697,9 @@ void Profiler::update(float deltaTime) {
         Mouse::setRelativeMode(!showProfiler);
     }
     setImguiIO(deltaTime);
+    Allocator::newFrame();
+    heapOffset = (heapOffset + 1) % PROFILER_HIST_SIZE;
+    heapAllocs[heapOffset] = Allocator::frame.allocs;
     ImGui::NewFrame();
     if(showProfiler) {
         wsize = Window::getInstance()->getSize();
@@ -256,6 +707,9 @@ void Profiler::update(float deltaTime) {
         ImGui::GetStyle().FrameRounding = 6;
         if(showTime) timeWindow();
         if(showLog) logWindow();
+        if(showMemory) memoryWindow();
+        if(showOverhead) overheadWindow();
+        if(showPacing) pacingWindow();
         renderCustomInterface();
         //ImGui::ShowTestWindow();
     }
@@ -264,31 +718,125 @@ void Profiler::update(float deltaTime) {
     timePassed += deltaTime;
     popMark(); //Profiler prepare
     resetTreeDraw();
+    bookkeeping = false;
 }
 
 void Profiler::draw() const {
     Profiler::pushMark("Profiler draw", "Time spent drawing the profiler UI");
+    bookkeeping = true;
     ImGui::Render();
+    bookkeeping = false;
     Profiler::popMark();
     popMark(); //draw
     resetTreeSwap();
 }
 
-void Profiler::processNodeAverage(const Profiler::Node& n) {
-    if(hist.find(n.name) == hist.end()) {
-        hist.insert(std::pair<std::string, Historial>(n.name, Historial(hist.size())));
-        memset(hist.at(n.name).past, 0, sizeof(float)*PROFILER_HIST_SIZE);
-    }
-    hist.at(n.name).current += n.getTime();
+double Profiler::processNodeAverage(const Profiler::Node& n) {
+    double childOverhead = 0.0;
     for(const Node& child : n.children)
-        processNodeAverage(child);
+        childOverhead += processNodeAverage(child);
+    Historial& h = getHistorial(n.name);
+    float time = n.getTime();
+    if(subtractOverhead) time = std::max(0.0, time - childOverhead - n.getCalls()*markInnerCost);
+    h.current += time;
+    h.variance += n.getTimeVariance();
+    if(n.sampling.budget > 0.0f) {
+        //timed calls are spread evenly over the frame instead of stopping
+        //when the budget runs out, which would only time the first ones
+        auto policy = sampling.find(n.name);
+        if(policy != sampling.end() && policy->second.budget > 0.0f)
+            policy->second.spread = (unsigned int) std::min(double(std::numeric_limits<unsigned int>::max()), std::max(1.0, std::ceil(double(n.getTime())/policy->second.budget)));
+    }
+    if(n.payload > 0.0) {
+        h.payload += n.payload;
+        h.payloadUnit = n.payloadUnit;
+        h.hasPayload = true;
+    }
+    h.allocs += n.allocs;
+    h.allocBytes += n.allocBytes;
+    if(n.hasCpu) {
+        const double scale = n.getSampleScale();
+        h.cpu.time += n.cpu.time*scale;
+        h.cpu.voluntary += n.cpu.voluntary*scale;
+        h.cpu.involuntary += n.cpu.involuntary*scale;
+        h.cpu.faults += n.cpu.faults*scale;
+        //the displayed time may have the overhead subtracted, the CPU time can't
+        h.cpuWall += n.getTime();
+    }
+    //roots aren't entered but are always timed, nodes that didn't run this
+    //frame (e.g. fixed update without steps) would only add zeros
+    if(n.getCalls() > 0 || n.getTime() > 0.0f) {
+        h.frameTime += time;
+        h.ran = true;
+    }
+    return childOverhead + n.getOverhead(timedPairCost, untimedPairCost);
+}
+
+Profiler::Historial& Profiler::getHistorial(const std::string& name) {
+    auto it = hist.find(name);
+    if(it == hist.end())
+        it = hist.insert(std::pair<std::string, Historial>(name, Historial(hist.size()))).first;
+    return it->second;
 }
 
 void Profiler::resetTreeWhole() const {
     treeWhole = Node("Whole frame", "Time spent on the whole frame", nullptr);
+    //placeholder so the UI lists it, update() sets it to the frame's overhead
+    treeWhole.children.push_back(Node("Measurement overhead", "Estimated cost of every pushMark/popMark pair in the frame", &treeWhole));
+    treeWhole.children.back().stop();
+    treeWhole.children.back().clearTime();
     currentNode = &treeWhole;
 }
 
+void Profiler::calibrate() {
+    //time empty marks under a scratch root, best of a few rounds
+    const int pairs = 1000;
+    const int rounds = 5;
+    Node root;
+    Sketch scratch; //keeps the calibration out of hist, a game mark may be called "Empty"
+    const size_t queued = timedCalls.size(); //the calibration calls are dropped
+    currentNode = &root;
+    timedPairCost = untimedPairCost = markInnerCost = 1.0;
+    for(int sampled = 0; sampled < 2; ++sampled) {
+        //added here so pushMark finds it instead of creating it with a history
+        root.children.push_back(Node("Empty", "", &root));
+        Node& mark = root.children.back();
+        mark.callSketch = &scratch;
+        pushMark("Empty", "");
+        popMark();
+        mark.sampling.oneIn = sampled ? 1 : std::numeric_limits<unsigned int>::max();
+        pushMark("Empty", ""); //second call is always timed
+        popMark();
+        double& cost = sampled ? timedPairCost : untimedPairCost;
+        for(int r = 0; r < rounds; ++r) {
+            mark.clearTime();
+            auto start = std::chrono::steady_clock::now();
+            for(int i = 0; i < pairs; ++i) {
+                pushMark("Empty", "");
+                popMark();
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            cost = std::min(cost, elapsed/pairs);
+            if(sampled) markInnerCost = std::min(markInnerCost, double(mark.getTime())/pairs);
+            timedCalls.resize(queued);
+        }
+        root.children.clear();
+    }
+    timedCalls.resize(queued);
+    currentNode = nullptr;
+}
+
+void Profiler::queueTimedCall(Sketch* sketch, float ms) {
+    if(timedCalls.size() == timedCalls.capacity()) {
+        //only grows while the timed calls per frame do, not the marked code's
+        const bool wasBookkeeping = bookkeeping;
+        bookkeeping = true;
+        timedCalls.reserve(std::max(size_t(256), timedCalls.capacity()*2));
+        bookkeeping = wasBookkeeping;
+    }
+    timedCalls.push_back(TimedCall{sketch, ms});
+}
+
 void Profiler::resetTreeDraw() const {
     treeDraw = Node("Draw", "Time spent issuing GL commands and drawing stuff on the screen", nullptr);
     currentNode = &treeDraw;
@@ -304,6 +852,12 @@ void Profiler::resetTreeFixed() const {
     currentNode = &treeFixed;
 }
 
+void Profiler::resumeTreeFixed() const {
+    //later fixed steps of the same frame add to the first one's tree
+    treeFixed.start();
+    currentNode = &treeFixed;
+}
+
 void Profiler::resetTreeSwap() const {
     treeSwap = Node("Swap", "Time spent waiting for the GPU to finish all pending jobs", nullptr);
     currentNode = &treeSwap;
@@ -332,14 +886,24 @@ void Profiler::timeWindow() const {
     ImGui::Separator();
     uiProcessNode(treeWhole);
     uiProcessNode(treeFixed);
+    const float fixedTime = getLastSample(treeFixed.name);
+    ImGui::Text("Fixed steps: %.2f per frame (max %i), %.2f ms per step", fixedStepsAvg, fixedStepsMax, fixedStepsAvg > 0.0f ? fixedTime/fixedStepsAvg : 0.0f);
     uiProcessNode(treeUpdate);
     uiProcessNode(treeDraw);
     uiProcessNode(treeSwap);
+    if(!counters.empty()) {
+        ImGui::Separator();
+        ImGui::PushID("Counters"); //their ids are counted apart from the marks'
+        for(const auto& entry : counters)
+            uiProcessCounter(entry.first, entry.second);
+        ImGui::PopID();
+    }
     ImGui::End();
 }
 
 void Profiler::logWindow() const {
     std::string log = Log::getContents();
+    logBytes = getStringBytes(log);
     ImGui::Begin("Log", nullptr, ImVec2(0.34f*wsize.x, 0.31f*wsize.y), windowAlpha);
     ImGui::SetWindowPos(ImVec2(0.025f*wsize.x, 0.61f*wsize.y), ImGuiCond_FirstUseEver);
     ImGui::BeginChild("Log");
@@ -348,18 +912,134 @@ void Profiler::logWindow() const {
     ImGui::End();
 }
 
+void Profiler::memoryWindow() const {
+    const Allocator::FrameStats& frame = Allocator::frame;
+    ImGui::Begin("ImGui Memory", nullptr, ImVec2(0.2f*wsize.x, 0.25f*wsize.y), windowAlpha);
+    ImGui::SetWindowPos(ImVec2(0.27f*wsize.x, 0.05f*wsize.y), ImGuiCond_FirstUseEver);
+    if(!Allocator::installed) {
+        ImGui::TextWrapped("ImGui allocated before the profiler was created. Call Profiler::installAllocator() before adding fonts to track its heap");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("Live: %.1f KB in %lu blocks", Allocator::liveBytes/1024.0f, (unsigned long int) Allocator::liveBlocks);
+    ImGui::Text("Peak: %.1f KB", Allocator::peakBytes/1024.0f);
+    ImGui::Text("Reserved: %.1f KB", Allocator::reservedBytes/1024.0f);
+    ImGui::Separator();
+    ImGui::Text("Last frame: %lu allocs, %lu frees, %.1f KB", frame.allocs, frame.frees, frame.bytes/1024.0f);
+    ImGui::Text("Scratch: %lu allocs, %u chunks pinned", frame.transientAllocs, Allocator::pinnedChunks);
+    ImGui::PlotHistogram("##allocs", heapAllocs, PROFILER_HIST_SIZE, (heapOffset + 1) % PROFILER_HIST_SIZE, "allocations per frame", 0.0f, FLT_MAX, vec2f(ImGui::GetContentRegionAvailWidth(), 60));
+    ImGui::End();
+}
+
+void Profiler::overheadWindow() const {
+    const MemoryUsage usage = getMemoryUsage();
+    ImGui::Begin("Profiler Overhead", nullptr, ImVec2(0.2f*wsize.x, 0.3f*wsize.y), windowAlpha);
+    ImGui::SetWindowPos(ImVec2(0.27f*wsize.x, 0.32f*wsize.y), ImGuiCond_FirstUseEver);
+    ImGui::Text("Prepare: %.3f ms", getLastSample("Profiler Prepare"));
+    ImGui::Text("Draw:    %.3f ms", getLastSample("Profiler draw"));
+    ImGui::Text("Marks:   %.3f ms", getLastSample("Measurement overhead"));
+    ImGui::Text("Mark cost: %.0f ns, %.0f ns sampled out", timedPairCost*1e9, untimedPairCost*1e9);
+    ImGui::Separator();
+    ImGui::Text("CPU: %.1f KB", (usage.nodes + usage.history + usage.strings + usage.imguiHeap)/1024.0f);
+    ImGui::BulletText("Marker nodes: %.1f KB", usage.nodes/1024.0f);
+    ImGui::BulletText("History: %.1f KB", usage.history/1024.0f);
+    ImGui::BulletText("Strings: %.1f KB", usage.strings/1024.0f);
+    ImGui::BulletText("ImGui heap: %.1f KB", usage.imguiHeap/1024.0f);
+    ImGui::Indent();
+    ImGui::BulletText("Draw lists: %.1f KB", usage.drawLists/1024.0f);
+    ImGui::BulletText("Font atlas: %.1f KB", usage.fontAtlas/1024.0f);
+    ImGui::Unindent();
+    ImGui::Text("GPU: %.1f KB", (usage.fontTexture + usage.meshBuffers)/1024.0f);
+    ImGui::BulletText("Font texture: %.1f KB", usage.fontTexture/1024.0f);
+    ImGui::BulletText("Mesh buffers: %.1f KB", usage.meshBuffers/1024.0f);
+    ImGui::End();
+}
+
+void Profiler::pacingWindow() const {
+    ImGui::Begin("Frame Pacing", nullptr, ImVec2(0.25f*wsize.x, 0.4f*wsize.y), windowAlpha);
+    ImGui::SetWindowPos(ImVec2(0.49f*wsize.x, 0.05f*wsize.y), ImGuiCond_FirstUseEver);
+    if(pacing.frames == 0) {
+        ImGui::End();
+        return;
+    }
+    const vec2f plotSize(ImGui::GetContentRegionAvailWidth(), 60);
+    ImGui::Text("Last %i frames, budget %.2f ms", pacing.frames, frameBudget);
+    ImGui::Text("Over budget: %i (%.1f%%)", pacing.overBudget, 100.0f*pacing.overBudget/pacing.frames);
+    char quantiles[64];
+    pacing.formatQuantiles(pacing.durations, quantiles, sizeof(quantiles));
+    ImGui::Text("Frame time %s ms", quantiles);
+    ImGui::PlotHistogram("##durations", pacing.durations, PROFILER_PACING_BINS, 0, "frame time", 0.0f, FLT_MAX, plotSize);
+    ImGui::Separator();
+    //judder: how much each frame differs from the one before it
+    const float judder = (pacing.deltaCount > 0) ? float(pacing.deltaSum/pacing.deltaCount) : 0.0f;
+    pacing.formatQuantiles(pacing.deltas, quantiles, sizeof(quantiles));
+    ImGui::Text("Judder mean %.2f  %s ms", judder, quantiles);
+    ImGui::PlotHistogram("##deltas", pacing.deltas, PROFILER_PACING_BINS, 0, "frame to frame change", 0.0f, FLT_MAX, plotSize);
+    ImGui::Text("Bins: under 0.25 ms, 4 per doubling, %.0f ms or more", Pacing::getBinValue(PROFILER_PACING_BINS - 1));
+    ImGui::End();
+}
+
+float Profiler::getLastSample(const std::string& name) const {
+    auto it = hist.find(name);
+    if(it == hist.end() || timeAvgOffset < 0) return 0.0f;
+    return it->second.past[timeAvgOffset];
+}
+
+//static
+size_t Profiler::getNodeBytes(const Profiler::Node& n) {
+    //list nodes carry two links besides the value
+    size_t bytes = sizeof(Node) + getStringBytes(n.name) + getStringBytes(n.desc);
+    for(const Node& child : n.children)
+        bytes += 2*sizeof(void*) + getNodeBytes(child);
+    return bytes;
+}
+
+//static
+size_t Profiler::getStringBytes(const std::string& s) {
+    //short strings are stored inside the object itself
+    const char* data = s.data();
+    if(data >= (const char*)&s && data < (const char*)(&s + 1)) return 0;
+    return s.capacity() + 1;
+}
+
 void Profiler::uiProcessNode(const Profiler::Node& n) const {
     const Historial& nHist = hist.at(n.name);
-    std::string currTime = toString(nHist.past[timeAvgOffset],4,2,true);
-    std::string tag = std::string(n.name + " Time (curr: ") + currTime + " ms)";
-    float max = 0.0f;
-    for(int i = 0; i < PROFILER_HIST_SIZE; ++i) max = std::max(max, nHist.past[i]);
-    if (ImGui::TreeNode((void*)nHist.id, "%s", tag.c_str())) {
-        ImGui::PlotLines(std::string(toString(max, 1, 1, false) + "ms\n\n\n\n0 ms").c_str(), nHist.past, PROFILER_HIST_SIZE, timeAvgOffset, currTime.c_str(), 0.00f, max, vec2f(350,60));
+    float max = nHist.getMax();
+    if(nHist.labelPushes != nHist.getPushes()) {
+        //only re-format when a new sample has been pushed
+        if(nHist.confidence > 0.0f) snprintf(nHist.currLabel, sizeof(nHist.currLabel), "%-4.2f \xC2\xB1%.0f%%", nHist.past[timeAvgOffset], nHist.confidence*100);
+        else snprintf(nHist.currLabel, sizeof(nHist.currLabel), "%-4.2f", nHist.past[timeAvgOffset]);
+        snprintf(nHist.scaleLabel, sizeof(nHist.scaleLabel), "%1.1fms\n\n\n\n0 ms", max);
+        if(!nHist.hasPayload) nHist.rateLabel[0] = '\0';
+        else if(nHist.payloadUnit == BYTES) snprintf(nHist.rateLabel, sizeof(nHist.rateLabel), ", %.1f MB/s", nHist.throughput);
+        else snprintf(nHist.rateLabel, sizeof(nHist.rateLabel), ", %.1f/ms", nHist.throughput);
+#ifdef PROFILER_TRACK_ALLOCATIONS
+        snprintf(nHist.allocLabel, sizeof(nHist.allocLabel), " [%.1f allocs, %.1f KB]", nHist.allocsPerFrame, nHist.allocBytesPerFrame/1024.0f);
+#endif
+        nHist.labelPushes = nHist.getPushes();
+    }
+    if (ImGui::TreeNode((void*)nHist.id, "%s Time (curr: %s ms%s)%s", n.name.c_str(), nHist.currLabel, nHist.rateLabel, nHist.allocLabel)) {
+        ImGui::PlotLines(nHist.scaleLabel, nHist.past, PROFILER_HIST_SIZE, timeAvgOffset, nHist.currLabel, 0.00f, max, vec2f(350,60));
         if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip("");
             ImGui::BeginTooltip();
             ImGui::Text("%s", n.desc.c_str());
+            if(nHist.hasPayload) {
+                if(nHist.payloadUnit == BYTES) ImGui::Text("Payload: %.1f KB per frame, %.1f MB/s", nHist.payloadPerFrame/1024.0f, nHist.throughput);
+                else ImGui::Text("Payload: %.1f items per frame, %.1f items/ms", nHist.payloadPerFrame, nHist.throughput);
+            }
+            if(cpuTiming) {
+                const CpuSample& cpu = nHist.cpuPerFrame;
+                ImGui::Text("CPU %.3f ms, waiting %.3f ms per frame", cpu.time, nHist.waitPerFrame);
+                ImGui::Text("Context switches %.1f voluntary, %.1f involuntary, page faults %.1f per frame", cpu.voluntary, cpu.involuntary, cpu.faults);
+            }
+            const Sketch* sketches[] = {&nHist.calls, &nHist.frames};
+            const char* labels[] = {"Per call ", "Per frame"};
+            for(int i = 0; i < 2; ++i) {
+                if(sketches[i]->getCount() == 0) continue;
+                ImGui::Text("%s p50 %.3f  p95 %.3f  p99 %.3f  max %.3f ms", labels[i], sketches[i]->getQuantile(0.5f),
+                            sketches[i]->getQuantile(0.95f), sketches[i]->getQuantile(0.99f), sketches[i]->getMax());
+            }
             ImGui::EndTooltip();
         }
         for(const Node& child : n.children)
@@ -368,6 +1048,459 @@ void Profiler::uiProcessNode(const Profiler::Node& n) const {
     }
 }
 
+void Profiler::uiProcessCounter(const std::string& name, const Profiler::Counter& c) const {
+    const Historial& cHist = c.history;
+    float min = cHist.getMin();
+    float max = std::max(cHist.getMax(), min + 1.0f); //flat counters still need a range to plot
+    if(cHist.labelPushes != cHist.getPushes()) {
+        snprintf(cHist.currLabel, sizeof(cHist.currLabel), "%-4.2f", cHist.past[timeAvgOffset]);
+        snprintf(cHist.scaleLabel, sizeof(cHist.scaleLabel), "%1.1f\n\n\n\n%1.1f", max, min);
+        cHist.labelPushes = cHist.getPushes();
+    }
+    if (ImGui::TreeNode((void*)cHist.id, "%s (curr: %s)", name.c_str(), cHist.currLabel)) {
+        ImGui::PlotLines(cHist.scaleLabel, cHist.past, PROFILER_HIST_SIZE, timeAvgOffset, cHist.currLabel, min, max, vec2f(350,60));
+        if (ImGui::IsItemHovered()) {
+            const char* modes[] = {"Sum per frame", "Last value", "Max per frame"};
+            ImGui::SetTooltip("%s, mean %.2f", modes[c.mode], cHist.getMean());
+        }
+        ImGui::TreePop();
+    }
+}
+
+//static
+double Profiler::Node::now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double Profiler::Node::stop() {
+    if(!timing) return 0.0;
+    double elapsed = now() - timeStart;
+    totalTime += elapsed;
+    timing = false;
+    return elapsed;
+}
+
+void Profiler::Node::enter() {
+    ++calls;
+    if(calls <= 2 || (calls - 1) % sampling.oneIn == 0)
+        start();
+}
+
+void Profiler::Node::leave() {
+    if(!timing) return;
+    double elapsed = stop();
+    ++samples;
+    sampleSqSum += elapsed*elapsed;
+    //bucketed by update() instead of inside the parent's time
+    if(callSketch != nullptr) instance->queueTimedCall(callSketch, float(elapsed*1000));
+}
+
+void Profiler::Node::startCpu() {
+    //only calls that are timed, so the scaling of sampled marks applies
+    if(!timing) return;
+    cpuStart = CpuSample::now();
+    cpuTiming = true;
+}
+
+void Profiler::Node::stopCpu() {
+    if(!cpuTiming) return;
+    CpuSample end = CpuSample::now();
+    cpu.time += end.time - cpuStart.time;
+    cpu.voluntary += end.voluntary - cpuStart.voluntary;
+    cpu.involuntary += end.involuntary - cpuStart.involuntary;
+    cpu.faults += end.faults - cpuStart.faults;
+    cpuTiming = false;
+    hasCpu = true;
+}
+
+void Profiler::Node::clearTime() {
+    totalTime = 0.0;
+    cpu = CpuSample();
+    hasCpu = false;
+    payload = 0.0;
+    allocs = 0;
+    allocBytes = 0;
+    calls = samples = 0;
+    sampleSqSum = 0.0;
+    for(Node& child : children) child.clearTime();
+}
+
+double Profiler::Node::getOverhead(double timedPair, double untimedPair) const {
+    unsigned int timed = std::min(samples, calls);
+    return timed*timedPair + (calls - timed)*untimedPair;
+}
+
+double Profiler::Node::getTimeVariance() const {
+    //variance of the scaled total, sampling without replacement from this frame's calls
+    if(samples < 2 || calls <= samples) return 0.0;
+    double mean = totalTime/samples;
+    double callVariance = std::max(0.0, (sampleSqSum - samples*mean*mean)/(samples - 1));
+    return double(calls)*calls*callVariance/samples*(1.0 - double(samples)/calls);
+}
+
+//static
+Profiler::CpuSample Profiler::CpuSample::now() {
+    CpuSample sample;
+#if defined(__linux__) || defined(__ANDROID__)
+    timespec ts;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        sample.time = ts.tv_sec + ts.tv_nsec*1e-9;
+    rusage usage;
+    if(getrusage(RUSAGE_THREAD, &usage) == 0) {
+        sample.voluntary = usage.ru_nvcsw;
+        sample.involuntary = usage.ru_nivcsw;
+        sample.faults = usage.ru_minflt + usage.ru_majflt;
+    }
+#endif
+    return sample;
+}
+
+Profiler::Historial::Historial(unsigned long int id) : id(id) {
+    memset(past, 0, sizeof(float)*PROFILER_HIST_SIZE);
+    currLabel[0] = scaleLabel[0] = rateLabel[0] = allocLabel[0] = '\0';
+}
+
+void Profiler::Historial::push(int offset, float sample) {
+    sum += sample - past[offset];
+    past[offset] = sample;
+    ++pushes;
+    pushExtreme(maxQueue, maxHead, maxCount, pushes, sample, true);
+    pushExtreme(minQueue, minHead, minCount, pushes, sample, false);
+}
+
+float Profiler::Historial::getMin() const {
+    if(pushes == 0) return 0.0f;
+    //samples never pushed are still zero in the ring
+    if(pushes < PROFILER_HIST_SIZE) return std::min(0.0f, minQueue[minHead].value);
+    return minQueue[minHead].value;
+}
+
+float Profiler::Historial::getMax() const {
+    if(pushes == 0) return 0.0f;
+    if(pushes < PROFILER_HIST_SIZE) return std::max(0.0f, maxQueue[maxHead].value);
+    return maxQueue[maxHead].value;
+}
+
+float Profiler::Historial::getMean() const {
+    return float(sum/PROFILER_HIST_SIZE);
+}
+
+//static
+void Profiler::Historial::pushExtreme(Extreme* queue, int& head, int& count, unsigned long int seq, float value, bool keepGreater) {
+    //drop the entry that falls out of the window, then every entry the new one dominates
+    if(count > 0 && queue[head].seq + PROFILER_HIST_SIZE <= seq) {
+        head = (head + 1) % PROFILER_HIST_SIZE;
+        --count;
+    }
+    while(count > 0) {
+        const Extreme& back = queue[(head + count - 1) % PROFILER_HIST_SIZE];
+        if(keepGreater ? back.value > value : back.value < value) break;
+        --count;
+    }
+    Extreme& e = queue[(head + count) % PROFILER_HIST_SIZE];
+    e.seq = seq;
+    e.value = value;
+    ++count;
+}
+
+struct Profiler::Allocator::Header {
+    Chunk* chunk; //owning arena chunk, nullptr otherwise
+    unsigned int size;
+    int sizeClass; //pool index, -1 otherwise
+};
+
+struct Profiler::Allocator::Chunk {
+    Chunk* next;
+    unsigned int used;
+    unsigned int live;
+};
+
+Profiler::Allocator::FrameStats Profiler::Allocator::frame;
+Profiler::Allocator::FrameStats Profiler::Allocator::current;
+size_t Profiler::Allocator::liveBytes = 0;
+size_t Profiler::Allocator::peakBytes = 0;
+size_t Profiler::Allocator::liveBlocks = 0;
+size_t Profiler::Allocator::reservedBytes = 0;
+unsigned int Profiler::Allocator::pinnedChunks = 0;
+Profiler::Allocator::Pool Profiler::Allocator::pools[8];
+Profiler::Allocator::Chunk* Profiler::Allocator::arena = nullptr;
+Profiler::Allocator::Chunk* Profiler::Allocator::pinned = nullptr;
+Profiler::Allocator::Chunk* Profiler::Allocator::spare = nullptr;
+bool Profiler::Allocator::installed = false;
+
+//static
+bool Profiler::Allocator::install() {
+    if(installed) return true;
+    //release() reads a header before every block, malloc'd ones have none
+    ImGuiIO& io = ImGui::GetIO();
+    if(io.MetricsAllocs != 0) return false;
+    //all state is plain static data, blocks can still be freed after
+    //the profiler is gone (the default font atlas is destroyed at exit)
+    io.MemAllocFn = &Allocator::allocate;
+    io.MemFreeFn = &Allocator::release;
+    io.MemAllocTransientFn = &Allocator::allocateTransient;
+    installed = true;
+    return true;
+}
+
+//static
+void Profiler::Allocator::newFrame() {
+    frame = current;
+    current = FrameStats();
+    if(arena == nullptr) return;
+    if(arena->live == 0) {
+        arena->used = ALLOCATOR_ALIGN;
+        return;
+    }
+    //scratch blocks that outlive their frame keep the chunk until they are freed
+    arena->next = pinned;
+    pinned = arena;
+    arena = nullptr;
+    ++pinnedChunks;
+}
+
+//static
+void* Profiler::Allocator::allocate(size_t size) {
+    int sizeClass = 0;
+    while(sizeClass < 8 && (size_t(16) << sizeClass) < size) ++sizeClass;
+    if(sizeClass == 8) {
+        Header* header = (Header*) malloc(ALLOCATOR_ALIGN + size);
+        return header ? track(header, size, -1, nullptr) : nullptr;
+    }
+    Pool& pool = pools[sizeClass];
+    const size_t blockSize = ALLOCATOR_ALIGN + (size_t(16) << sizeClass);
+    Header* header = (Header*) pool.freeList;
+    if(header != nullptr)
+        pool.freeList = *(void**)((char*)header + ALLOCATOR_ALIGN);
+    else {
+        if(pool.cursor == nullptr || pool.cursor + blockSize > pool.end) {
+            pool.cursor = (char*) malloc(ALLOCATOR_PAGE_SIZE);
+            if(pool.cursor == nullptr) return nullptr;
+            pool.end = pool.cursor + ALLOCATOR_PAGE_SIZE;
+            reservedBytes += ALLOCATOR_PAGE_SIZE;
+        }
+        header = (Header*) pool.cursor;
+        pool.cursor += blockSize;
+    }
+    return track(header, size, sizeClass, nullptr);
+}
+
+//static
+void* Profiler::Allocator::allocateTransient(size_t size) {
+    const size_t blockSize = ALLOCATOR_ALIGN + ((size + ALLOCATOR_ALIGN - 1) & ~size_t(ALLOCATOR_ALIGN - 1));
+    if(blockSize > ALLOCATOR_CHUNK_SIZE/4)
+        return allocate(size);
+    if(arena == nullptr || arena->used + blockSize > ALLOCATOR_CHUNK_SIZE) {
+        if(arena != nullptr && arena->live == 0)
+            arena->used = ALLOCATOR_ALIGN;
+        else {
+            if(arena != nullptr) {
+                arena->next = pinned;
+                pinned = arena;
+                ++pinnedChunks;
+            }
+            arena = spare;
+            if(arena != nullptr)
+                spare = arena->next;
+            else {
+                arena = (Chunk*) malloc(ALLOCATOR_CHUNK_SIZE);
+                if(arena == nullptr) return allocate(size);
+                reservedBytes += ALLOCATOR_CHUNK_SIZE;
+            }
+            arena->used = ALLOCATOR_ALIGN;
+            arena->live = 0;
+        }
+    }
+    Header* header = (Header*)((char*)arena + arena->used);
+    arena->used += blockSize;
+    ++arena->live;
+    ++current.transientAllocs;
+    return track(header, size, -1, arena);
+}
+
+//static
+void Profiler::Allocator::release(void* ptr) {
+    if(ptr == nullptr) return;
+    Header* header = (Header*)((char*)ptr - ALLOCATOR_ALIGN);
+    ++current.frees;
+    liveBytes -= header->size;
+    --liveBlocks;
+    if(header->chunk != nullptr) {
+        Chunk* chunk = header->chunk;
+        if(--chunk->live == 0) {
+            if(chunk == arena) chunk->used = ALLOCATOR_ALIGN;
+            else recycle(chunk);
+        }
+    }
+    else if(header->sizeClass >= 0) {
+        Pool& pool = pools[header->sizeClass];
+        *(void**)ptr = pool.freeList;
+        pool.freeList = header;
+    }
+    else free(header);
+}
+
+//static
+void* Profiler::Allocator::track(Header* header, size_t size, int sizeClass, Chunk* chunk) {
+    static_assert(sizeof(Header) <= ALLOCATOR_ALIGN && sizeof(Chunk) <= ALLOCATOR_ALIGN, "Allocator headers break alignment");
+    header->chunk = chunk;
+    header->size = (unsigned int) size;
+    header->sizeClass = sizeClass;
+#ifdef PROFILER_TRACK_ALLOCATIONS
+    countAllocation(size);
+#endif
+    ++current.allocs;
+    current.bytes += size;
+    liveBytes += size;
+    ++liveBlocks;
+    if(liveBytes > peakBytes) peakBytes = liveBytes;
+    return (char*)header + ALLOCATOR_ALIGN;
+}
+
+//static
+void Profiler::Allocator::recycle(Chunk* chunk) {
+    //the last block of a pinned chunk went away, keep one chunk around for the next arena
+    Chunk** link = &pinned;
+    while(*link != chunk) link = &(*link)->next;
+    *link = chunk->next;
+    --pinnedChunks;
+    if(spare == nullptr) {
+        chunk->next = nullptr;
+        spare = chunk;
+    }
+    else {
+        free(chunk);
+        reservedBytes -= ALLOCATOR_CHUNK_SIZE;
+    }
+}
+
+void Profiler::Sketch::add(float ms) {
+    ++buckets[getBucket(ms*1e6)];
+    ++count;
+    max = std::max(max, ms);
+}
+
+void Profiler::Sketch::merge(const Sketch& other) {
+    for(int i = 0; i < PROFILER_SKETCH_BUCKETS; ++i)
+        buckets[i] += other.buckets[i];
+    count += other.count;
+    max = std::max(max, other.max);
+}
+
+void Profiler::Sketch::subtract(const Sketch& earlier) {
+    //the exact max is gone, fall back to the highest bucket left
+    max = 0.0f;
+    for(int i = 0; i < PROFILER_SKETCH_BUCKETS; ++i) {
+        buckets[i] -= earlier.buckets[i];
+        if(buckets[i] != 0) max = float(getBucketValue(i)*1e-6);
+    }
+    count -= earlier.count;
+}
+
+float Profiler::Sketch::getQuantile(float q) const {
+    if(count == 0) return 0.0f;
+    if(q >= 1.0f) return max;
+    uint64_t rank = std::max(uint64_t(1), uint64_t(std::ceil(double(q)*count)));
+    uint64_t seen = 0;
+    for(int i = 0; i < PROFILER_SKETCH_BUCKETS; ++i) {
+        seen += buckets[i];
+        if(seen >= rank) return std::min(max, float(getBucketValue(i)*1e-6));
+    }
+    return max;
+}
+
+//static
+int Profiler::Sketch::getBucket(double ns) {
+    //below 16ns buckets are 1ns wide, then 16 per power of two
+    if(ns < 16.0) return std::max(0, int(ns));
+    int exponent;
+    double mantissa = std::frexp(ns, &exponent); //[0.5, 1)
+    int power = exponent - 1;
+    if(power >= 40) return PROFILER_SKETCH_BUCKETS - 1;
+    return (power - 3)*16 + int((mantissa*2.0 - 1.0)*16.0);
+}
+
+//static
+double Profiler::Sketch::getBucketValue(int bucket) {
+    //middle of the bucket
+    if(bucket < 16) return bucket + 0.5;
+    int power = bucket/16 + 3;
+    double width = std::ldexp(1.0, power - 4);
+    return std::ldexp(1.0, power) + (bucket%16 + 0.5)*width;
+}
+
+void Profiler::Pacing::push(float ms, float budget) {
+    Frame& frame = ring[head];
+    if(frames == PROFILER_PACING_FRAMES) {
+        //forget the frame being overwritten
+        --durations[frame.duration];
+        if(frame.hasDelta) {
+            --deltas[frame.deltaBin];
+            deltaSum -= frame.delta;
+            --deltaCount;
+        }
+        overBudget -= frame.overBudget;
+    }
+    else ++frames;
+    frame.duration = (unsigned char) getBin(ms);
+    frame.hasDelta = (last >= 0.0f);
+    frame.delta = frame.hasDelta ? std::abs(ms - last) : 0.0f;
+    frame.deltaBin = (unsigned char) getBin(frame.delta);
+    frame.overBudget = (ms > budget);
+    ++durations[frame.duration];
+    if(frame.hasDelta) {
+        ++deltas[frame.deltaBin];
+        deltaSum += frame.delta;
+        ++deltaCount;
+    }
+    overBudget += frame.overBudget;
+    last = ms;
+    head = (head + 1) % PROFILER_PACING_FRAMES;
+}
+
+float Profiler::Pacing::getQuantile(const float* bins, float q) const {
+    float total = 0.0f;
+    for(int i = 0; i < PROFILER_PACING_BINS; ++i) total += bins[i];
+    if(total <= 0.0f) return 0.0f;
+    float seen = 0.0f;
+    for(int i = 0; i < PROFILER_PACING_BINS; ++i) {
+        seen += bins[i];
+        if(seen >= q*total) return getBinValue(i);
+    }
+    return getBinValue(PROFILER_PACING_BINS - 1);
+}
+
+void Profiler::Pacing::formatQuantiles(const float* bins, char* label, size_t size) const {
+    const float qs[] = {0.5f, 0.95f, 0.99f};
+    const char* names[] = {"p50", "p95", "p99"};
+    const float open = getBinValue(PROFILER_PACING_BINS - 1);
+    size_t used = 0;
+    label[0] = '\0';
+    for(int i = 0; i < 3 && used < size; ++i) {
+        float value = getQuantile(bins, qs[i]);
+        int written = (value >= open) ? snprintf(label + used, size - used, "%s%s >=%.0f", i ? "  " : "", names[i], value)
+                                      : snprintf(label + used, size - used, "%s%s %.2f", i ? "  " : "", names[i], value);
+        if(written < 0) break;
+        used += written;
+    }
+}
+
+//static
+int Profiler::Pacing::getBin(float ms) {
+    if(ms < 0.25f) return 0;
+    return std::min(PROFILER_PACING_BINS - 1, 1 + int(std::log2(ms*4.0f)*4.0f));
+}
+
+//static
+float Profiler::Pacing::getBinValue(int bin) {
+    //below 0.25ms reads as 0 so steady frames show no judder, and the open
+    //bin from 256ms as its lower edge
+    if(bin == 0) return 0.0f;
+    if(bin == PROFILER_PACING_BINS - 1) return 256.0f;
+    //geometric middle of the bin
+    return 0.25f*std::exp2((bin - 0.5f)/4.0f);
+}
+
 Profiler::Watcher::Watcher() {
     //Update and draw first of all
     setUpdatePriority(-1000);
@@ -380,7 +1513,8 @@ Profiler::Watcher::~Watcher() {
 void Profiler::Watcher::fixedUpdate(float deltaTime) {
     (void) deltaTime;
     if(instance->currentNode != nullptr && instance->currentNode->name == "Swap") popMark(); //swap
-    Profiler::instance->resetTreeFixed();
+    if(instance->fixedSteps++ == 0) Profiler::instance->resetTreeFixed();
+    else Profiler::instance->resumeTreeFixed();
 }
 
 void Profiler::Watcher::update(float deltaTime) {
@@ -732,6 +732,7 @@ ImGuiStyle::ImGuiStyle()
     DisplaySafeAreaPadding  = ImVec2(4,4);      // If you cannot see the edge of your screen (e.g. on a TV) increase the safe area padding. Covers popups/tooltips as well regular windows.
     AntiAliasedLines        = true;             // Enable anti-aliasing on lines/borders. Disable if you are really short on CPU/GPU.
     AntiAliasedShapes       = true;             // Enable anti-aliasing on filled shapes (rounded rectangles, circles, etc.)
+    JoinedLines             = true;             // Share vertices between consecutive segments of non anti-aliased lines (mitered joins, split at corners sharper than 90 degrees). Disable to get one quad per segment.
     CurveTessellationTol    = 1.25f;            // Tessellation tolerance. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
 
     ImGui::StyleColorsClassic(this);
@@ -799,6 +800,7 @@ ImGuiIO::ImGuiIO()
     RenderDrawListsFn = NULL;
     MemAllocFn = malloc;
     MemFreeFn = free;
+    MemAllocTransientFn = NULL;
     GetClipboardTextFn = GetClipboardTextFn_DefaultImpl;   // Platform dependent default implementations
     SetClipboardTextFn = SetClipboardTextFn_DefaultImpl;
     ClipboardUserData = NULL;
@@ -1013,54 +1015,189 @@ int ImFormatStringV(char* buf, int buf_size, const char* fmt, va_list args)
 }
 #endif // #ifdef IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS
 
-// Pass data_size==0 for zero-terminated strings
-// FIXME-OPT: Replace with e.g. FNV1a hash? CRC32 pretty much randomly access 1KB. Need to do proper measurements.
-ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+// CRC32 by default. IMGUI_USE_CRC32C_HASH switches to CRC32C, which SSE4.2 and ARMv8 compute in hardware (same values with the table fallback).
+#ifdef IMGUI_USE_CRC32C_HASH
+#define IM_HASH_CRC32_POLYNOMIAL    0x82F63B78
+#if !defined(IMGUI_DISABLE_SIMD) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define IMGUI_HASH_CRC32C_SSE42
+#elif !defined(IMGUI_DISABLE_SIMD) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define IMGUI_HASH_CRC32C_ARM
+#endif
+#else
+#define IM_HASH_CRC32_POLYNOMIAL    0xEDB88320
+#endif
+
+static ImU32 ImHashCrc32(ImU32 crc, const unsigned char* data, size_t data_size)
 {
-    static ImU32 crc32_lut[256] = { 0 };
-    if (!crc32_lut[1])
+#if defined(IMGUI_HASH_CRC32C_SSE42)
+#if defined(__x86_64__) || defined(_M_X64)
+    for (; data_size >= 8; data += 8, data_size -= 8)
+    {
+        ImU64 v;
+        memcpy(&v, data, 8);
+        crc = (ImU32)_mm_crc32_u64(crc, v);
+    }
+#endif
+    for (; data_size >= 4; data += 4, data_size -= 4)
+    {
+        unsigned int v;
+        memcpy(&v, data, 4);
+        crc = _mm_crc32_u32(crc, v);
+    }
+    while (data_size--)
+        crc = _mm_crc32_u8(crc, *data++);
+#elif defined(IMGUI_HASH_CRC32C_ARM)
+    for (; data_size >= 8; data += 8, data_size -= 8)
+    {
+        ImU64 v;
+        memcpy(&v, data, 8);
+        crc = __crc32cd(crc, v);
+    }
+    while (data_size--)
+        crc = __crc32cb(crc, *data++);
+#else
+    // Slice-by-8: one lookup per input byte like the classic table, but 8 independent lookups per step instead of a serial chain
+    static ImU32 crc32_lut[8][256] = { { 0 } };
+    if (!crc32_lut[0][1])
     {
-        const ImU32 polynomial = 0xEDB88320;
         for (ImU32 i = 0; i < 256; i++)
         {
-            ImU32 crc = i;
+            ImU32 c = i;
             for (ImU32 j = 0; j < 8; j++)
-                crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & polynomial);
-            crc32_lut[i] = crc;
+                c = (c >> 1) ^ (ImU32(-int(c & 1)) & IM_HASH_CRC32_POLYNOMIAL);
+            crc32_lut[0][i] = c;
         }
+        for (ImU32 i = 0; i < 256; i++)
+            for (int t = 1; t < 8; t++)
+                crc32_lut[t][i] = (crc32_lut[t - 1][i] >> 8) ^ crc32_lut[0][crc32_lut[t - 1][i] & 0xFF];
     }
-
-    seed = ~seed;
-    ImU32 crc = seed;
-    const unsigned char* current = (const unsigned char*)data;
-
-    if (data_size > 0)
+    for (; data_size >= 8; data += 8, data_size -= 8)
     {
-        // Known size
-        while (data_size--)
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *current++];
+        const ImU32 lo = crc ^ ((ImU32)data[0] | ((ImU32)data[1] << 8) | ((ImU32)data[2] << 16) | ((ImU32)data[3] << 24));
+        const ImU32 hi = (ImU32)data[4] | ((ImU32)data[5] << 8) | ((ImU32)data[6] << 16) | ((ImU32)data[7] << 24);
+        crc = crc32_lut[7][lo & 0xFF] ^ crc32_lut[6][(lo >> 8) & 0xFF] ^ crc32_lut[5][(lo >> 16) & 0xFF] ^ crc32_lut[4][lo >> 24] ^
+              crc32_lut[3][hi & 0xFF] ^ crc32_lut[2][(hi >> 8) & 0xFF] ^ crc32_lut[1][(hi >> 16) & 0xFF] ^ crc32_lut[0][hi >> 24];
     }
-    else
+    while (data_size--)
+        crc = (crc >> 8) ^ crc32_lut[0][(crc & 0xFF) ^ *data++];
+#endif
+    return crc;
+}
+
+// Pass data_size==0 for zero-terminated strings
+ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+{
+    const unsigned char* current = (const unsigned char*)data;
+    size_t current_size = (size_t)data_size;
+    if (data_size <= 0)
     {
         // Zero-terminated string
-        while (unsigned char c = *current++)
+        // We support a syntax of "label###id" where only "###id" is included in the hash, and only "label" gets displayed.
+        // Every ### discards the hash so far, so we hash from the last one. Labels rarely contain '#', memchr() skips through them quickly.
+        const char* str = (const char*)data;
+        const char* str_end = str + strlen(str);
+        for (const char* p = str; (p = (const char*)memchr(p, '#', (size_t)(str_end - p))) != NULL; p++)
+            if (str_end - p >= 3 && p[1] == '#' && p[2] == '#')
+                current = (const unsigned char*)p;
+        current_size = (size_t)(str_end - (const char*)current);
+    }
+    return ~ImHashCrc32(~seed, current, current_size);
+}
+
+void ImMinMax(const float* values, int values_count, float* out_min, float* out_max)
+{
+    IM_ASSERT(values_count > 0);
+    int i = 0;
+    float v_min = values[0];
+    float v_max = values[0];
+#if defined(IMGUI_ENABLE_SSE2)
+    if (values_count >= 4)
+    {
+        __m128 vec_min = _mm_loadu_ps(values);
+        __m128 vec_max = vec_min;
+        for (i = 4; i + 4 <= values_count; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps(values + i);
+            vec_min = _mm_min_ps(vec_min, v);
+            vec_max = _mm_max_ps(vec_max, v);
+        }
+        vec_min = _mm_min_ps(vec_min, _mm_movehl_ps(vec_min, vec_min));
+        vec_max = _mm_max_ps(vec_max, _mm_movehl_ps(vec_max, vec_max));
+        vec_min = _mm_min_ss(vec_min, _mm_shuffle_ps(vec_min, vec_min, 1));
+        vec_max = _mm_max_ss(vec_max, _mm_shuffle_ps(vec_max, vec_max, 1));
+        v_min = _mm_cvtss_f32(vec_min);
+        v_max = _mm_cvtss_f32(vec_max);
+    }
+#elif defined(IMGUI_ENABLE_NEON)
+    if (values_count >= 4)
+    {
+        float32x4_t vec_min = vld1q_f32(values);
+        float32x4_t vec_max = vec_min;
+        for (i = 4; i + 4 <= values_count; i += 4)
         {
-            // We support a syntax of "label###id" where only "###id" is included in the hash, and only "label" gets displayed.
-            // Because this syntax is rarely used we are optimizing for the common case.
-            // - If we reach ### in the string we discard the hash so far and reset to the seed.
-            // - We don't do 'current += 2; continue;' after handling ### to keep the code smaller.
-            if (c == '#' && current[0] == '#' && current[1] == '#')
-                crc = seed;
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
+            const float32x4_t v = vld1q_f32(values + i);
+            vec_min = vminq_f32(vec_min, v);
+            vec_max = vmaxq_f32(vec_max, v);
         }
+        float32x2_t half_min = vpmin_f32(vget_low_f32(vec_min), vget_high_f32(vec_min));
+        float32x2_t half_max = vpmax_f32(vget_low_f32(vec_max), vget_high_f32(vec_max));
+        v_min = vget_lane_f32(vpmin_f32(half_min, half_min), 0);
+        v_max = vget_lane_f32(vpmax_f32(half_max, half_max), 0);
     }
-    return ~crc;
+#endif
+    for (; i < values_count; i++)
+    {
+        v_min = ImMin(v_min, values[i]);
+        v_max = ImMax(v_max, values[i]);
+    }
+    *out_min = v_min;
+    *out_max = v_max;
 }
 
 //-----------------------------------------------------------------------------
 // ImText* helpers
 //-----------------------------------------------------------------------------
 
+// Text is mostly printable ASCII, which the text functions can handle without decoding or checking for control characters.
+// Bytes >= 0x80 are negative as signed chars, so a single signed compare against ' ' finds both control characters and UTF-8 sequences.
+const char* ImTextSkipPrintableAscii(const char* in_text, const char* in_text_end)
+{
+    const char* s = in_text;
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    for (; in_text_end - s >= 32; s += 32)
+    {
+        const __m128i stop_lo = _mm_cmplt_epi8(_mm_loadu_si128((const __m128i*)s), space);
+        const __m128i stop_hi = _mm_cmplt_epi8(_mm_loadu_si128((const __m128i*)(s + 16)), space);
+        if (_mm_movemask_epi8(_mm_or_si128(stop_lo, stop_hi)) != 0)
+            break;
+    }
+    for (; in_text_end - s >= 16; s += 16)
+        if (_mm_movemask_epi8(_mm_cmplt_epi8(_mm_loadu_si128((const __m128i*)s), space)) != 0)
+            break;
+#elif defined(IMGUI_ENABLE_NEON)
+    const int8x16_t space = vdupq_n_s8(' ');
+    for (; in_text_end - s >= 32; s += 32)
+    {
+        const uint8x16_t stop = vorrq_u8(vcltq_s8(vld1q_s8((const int8_t*)s), space), vcltq_s8(vld1q_s8((const int8_t*)(s + 16)), space));
+        const uint64x2_t stop64 = vreinterpretq_u64_u8(stop);
+        if ((vgetq_lane_u64(stop64, 0) | vgetq_lane_u64(stop64, 1)) != 0)
+            break;
+    }
+    for (; in_text_end - s >= 16; s += 16)
+    {
+        const uint64x2_t stop64 = vreinterpretq_u64_u8(vcltq_s8(vld1q_s8((const int8_t*)s), space));
+        if ((vgetq_lane_u64(stop64, 0) | vgetq_lane_u64(stop64, 1)) != 0)
+            break;
+    }
+#endif
+    while (s < in_text_end && (signed char)*s >= ' ')
+        s++;
+    return s;
+}
+
 // Convert UTF-8 to 32-bits character, process single character input.
 // Based on stb_from_utf8() from github.com/nothings/stb/
 // We handle UTF-8 decoding error by skipping forward.
@@ -1399,27 +1536,72 @@ void* ImFileLoadToMemory(const char* filename, const char* file_open_mode, int*
 // Helper: Key->value storage
 //-----------------------------------------------------------------------------
 
-// std::lower_bound but without the bullshit
-static ImVector<ImGuiStorage::Pair>::iterator LowerBound(ImVector<ImGuiStorage::Pair>& data, ImGuiID key)
+// IDs are already hashed, but users also store small sequential keys, so mix the high bits down before masking.
+static inline int StorageIndexSlot(ImGuiID key, int mask)
 {
-    ImVector<ImGuiStorage::Pair>::iterator first = data.begin();
-    ImVector<ImGuiStorage::Pair>::iterator last = data.end();
-    size_t count = (size_t)(last - first);
-    while (count > 0)
+    ImU32 h = key * 0x9E3779B1;
+    return (int)((h ^ (h >> 15)) & (ImU32)mask);
+}
+
+// Returns the index of the pair in Data, or -1
+static int StorageFind(const ImGuiStorage* storage, ImGuiID key)
+{
+    const ImVector<ImGuiStorage::Pair>& data = storage->Data;
+    if (storage->IndexedCount != data.Size)
     {
-        size_t count2 = count >> 1;
-        ImVector<ImGuiStorage::Pair>::iterator mid = first + count2;
-        if (mid->key < key)
-        {
-            first = ++mid;
-            count -= count2 + 1;
-        }
-        else
-        {
-            count = count2;
-        }
+        // Data was modified without going through the API (e.g. filled before BuildSortByKey()), the index can't be trusted.
+        for (int n = 0; n < data.Size; n++)
+            if (data[n].key == key)
+                return n;
+        return -1;
+    }
+    const ImVector<int>& index = storage->Index;
+    if (index.Size == 0)
+        return -1;
+    const int mask = index.Size - 1;
+    for (int slot = StorageIndexSlot(key, mask); index[slot] != 0; slot = (slot + 1) & mask)
+        if (data[index[slot] - 1].key == key)
+            return index[slot] - 1;
+    return -1;
+}
+
+static void StorageBuildIndex(ImGuiStorage* storage, int min_count)
+{
+    // Keep the table at most half full so probe sequences stay short
+    int capacity = 16;
+    while (capacity < min_count * 2)
+        capacity *= 2;
+    ImVector<int>& index = storage->Index;
+    index.reserve(capacity);
+    index.resize(capacity);
+    memset(index.Data, 0, (size_t)capacity * sizeof(int));
+    const int mask = capacity - 1;
+    for (int n = 0; n < storage->Data.Size; n++)
+    {
+        int slot = StorageIndexSlot(storage->Data[n].key, mask);
+        while (index[slot] != 0)
+            slot = (slot + 1) & mask;
+        index[slot] = n + 1;
     }
-    return first;
+    storage->IndexedCount = storage->Data.Size;
+}
+
+// Returns the existing pair for the key, or appends 'default_pair'
+static ImGuiStorage::Pair* StorageFindOrAdd(ImGuiStorage* storage, const ImGuiStorage::Pair& default_pair)
+{
+    ImVector<ImGuiStorage::Pair>& data = storage->Data;
+    if (storage->IndexedCount != data.Size || (data.Size + 1) * 2 > storage->Index.Size)
+        StorageBuildIndex(storage, data.Size + 1);
+    ImVector<int>& index = storage->Index;
+    const int mask = index.Size - 1;
+    int slot = StorageIndexSlot(default_pair.key, mask);
+    for (; index[slot] != 0; slot = (slot + 1) & mask)
+        if (data[index[slot] - 1].key == default_pair.key)
+            return &data[index[slot] - 1];
+    data.push_back(default_pair);
+    index[slot] = data.Size;
+    storage->IndexedCount = data.Size;
+    return &data.back();
 }
 
 // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
@@ -1437,14 +1619,13 @@ void ImGuiStorage::BuildSortByKey()
     };
     if (Data.Size > 1)
         qsort(Data.Data, (size_t)Data.Size, sizeof(Pair), StaticFunc::PairCompareByID);
+    StorageBuildIndex(this, Data.Size);
 }
 
 int ImGuiStorage::GetInt(ImGuiID key, int default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_i;
+    int n = StorageFind(this, key);
+    return n >= 0 ? Data[n].val_i : default_val;
 }
 
 bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
@@ -1454,27 +1635,20 @@ bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
 
 float ImGuiStorage::GetFloat(ImGuiID key, float default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_f;
+    int n = StorageFind(this, key);
+    return n >= 0 ? Data[n].val_f : default_val;
 }
 
 void* ImGuiStorage::GetVoidPtr(ImGuiID key) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return NULL;
-    return it->val_p;
+    int n = StorageFind(this, key);
+    return n >= 0 ? Data[n].val_p : NULL;
 }
 
 // References are only valid until a new value is added to the storage. Calling a Set***() function or a Get***Ref() function invalidates the pointer.
 int* ImGuiStorage::GetIntRef(ImGuiID key, int default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_i;
+    return &StorageFindOrAdd(this, Pair(key, default_val))->val_i;
 }
 
 bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
@@ -1484,30 +1658,17 @@ bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
 
 float* ImGuiStorage::GetFloatRef(ImGuiID key, float default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_f;
+    return &StorageFindOrAdd(this, Pair(key, default_val))->val_f;
 }
 
 void** ImGuiStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_p;
+    return &StorageFindOrAdd(this, Pair(key, default_val))->val_p;
 }
 
-// FIXME-OPT: Need a way to reuse the result of lower_bound when doing GetInt()/SetInt() - not too bad because it only happens on explicit interaction (maximum one a frame)
 void ImGuiStorage::SetInt(ImGuiID key, int val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_i = val;
+    StorageFindOrAdd(this, Pair(key, val))->val_i = val;
 }
 
 void ImGuiStorage::SetBool(ImGuiID key, bool val)
@@ -1517,24 +1678,12 @@ void ImGuiStorage::SetBool(ImGuiID key, bool val)
 
 void ImGuiStorage::SetFloat(ImGuiID key, float val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_f = val;
+    StorageFindOrAdd(this, Pair(key, val))->val_f = val;
 }
 
 void ImGuiStorage::SetVoidPtr(ImGuiID key, void* val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_p = val;
+    StorageFindOrAdd(this, Pair(key, val))->val_p = val;
 }
 
 void ImGuiStorage::SetAllInt(int v)
@@ -2150,6 +2299,12 @@ void* ImGui::MemAlloc(size_t sz)
     return GImGui->IO.MemAllocFn(sz);
 }
 
+void* ImGui::MemAllocTransient(size_t sz)
+{
+    GImGui->IO.MetricsAllocs++;
+    return GImGui->IO.MemAllocTransientFn ? GImGui->IO.MemAllocTransientFn(sz) : GImGui->IO.MemAllocFn(sz);
+}
+
 void ImGui::MemFree(void* ptr)
 {
     if (ptr) GImGui->IO.MetricsAllocs--;
@@ -7581,6 +7736,37 @@ bool ImGui::DragIntRange2(const char* label, int* v_current_min, int* v_current_
     return value_changed;
 }
 
+struct ImGuiPlotArrayGetterData
+{
+    const float* Values;
+    int Stride;
+
+    ImGuiPlotArrayGetterData(const float* values, int stride) { Values = values; Stride = stride; }
+};
+
+static float Plot_ArrayGetter(void* data, int idx)
+{
+    ImGuiPlotArrayGetterData* plot_data = (ImGuiPlotArrayGetterData*)data;
+    const float v = *(float*)(void*)((unsigned char*)plot_data->Values + (size_t)idx * plot_data->Stride);
+    return v;
+}
+
+// Min/max of the ring buffer samples [first, last] (logical indices, inclusive) stored contiguously from 'values' and rotated by 'values_offset'
+static void Plot_RingMinMax(const float* values, int values_count, int values_offset, int first, int last, float* out_min, float* out_max)
+{
+    int begin = (first + values_offset) % values_count;
+    int count = last - first + 1;
+    int head = ImMin(count, values_count - begin);
+    ImMinMax(values + begin, head, out_min, out_max);
+    if (head < count)
+    {
+        float tail_min, tail_max;
+        ImMinMax(values, count - head, &tail_min, &tail_max);
+        *out_min = ImMin(*out_min, tail_min);
+        *out_max = ImMax(*out_max, tail_max);
+    }
+}
+
 void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
 {
     ImGuiWindow* window = GetCurrentWindow();
@@ -7604,16 +7790,28 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
         return;
     const bool hovered = ItemHoverable(inner_bb, 0);
 
+    // Contiguous float arrays can be scanned directly instead of going through the getter
+    const float* values_contiguous = NULL;
+    if (values_getter == &Plot_ArrayGetter && ((ImGuiPlotArrayGetterData*)data)->Stride == sizeof(float))
+        values_contiguous = ((ImGuiPlotArrayGetterData*)data)->Values;
+
     // Determine scale from values if not specified
     if (scale_min == FLT_MAX || scale_max == FLT_MAX)
     {
         float v_min = FLT_MAX;
         float v_max = -FLT_MAX;
-        for (int i = 0; i < values_count; i++)
+        if (values_contiguous && values_count > 0)
+        {
+            ImMinMax(values_contiguous, values_count, &v_min, &v_max);
+        }
+        else
         {
-            const float v = values_getter(data, i);
-            v_min = ImMin(v_min, v);
-            v_max = ImMax(v_max, v);
+            for (int i = 0; i < values_count; i++)
+            {
+                const float v = values_getter(data, i);
+                v_min = ImMin(v_min, v);
+                v_max = ImMax(v_max, v);
+            }
         }
         if (scale_min == FLT_MAX)
             scale_min = v_min;
@@ -7655,7 +7853,41 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
         const ImU32 col_base = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram);
         const ImU32 col_hovered = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLinesHovered : ImGuiCol_PlotHistogramHovered);
 
-        for (int n = 0; n < res_w; n++)
+        // Long contiguous series: decimate to one min/max pair per pixel column and stroke them as a single path instead of
+        // picking one sample per column. Each column covers the samples between its neighbours (inclusive) so spikes are never lost.
+        const bool decimate = (plot_type == ImGuiPlotType_Lines) && values_contiguous && item_count > res_w * 2;
+        ImRect hovered_column(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (int n = 0; decimate && n <= res_w; n++)
+        {
+            const int first = (int)((float)n * item_count / res_w);
+            const int last = ImMin((int)((float)(n + 1) * item_count / res_w), item_count);
+            float v_min, v_max;
+            Plot_RingMinMax(values_contiguous, values_count, values_offset, first, last, &v_min, &v_max);
+            const float x = ImLerp(inner_bb.Min.x, inner_bb.Max.x, (float)n * t_step);
+            const float y_max = ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((v_max - scale_min) / (scale_max - scale_min)));
+            const float y_min = ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((v_min - scale_min) / (scale_max - scale_min)));
+            if (y_min - y_max < 1.0f)
+            {
+                // Sub-pixel extent: a single point keeps the geometry as small as one line per column
+                window->DrawList->PathLineTo(ImVec2(x, (y_min + y_max) * 0.5f));
+            }
+            else
+            {
+                window->DrawList->PathLineTo(ImVec2(x, y_max));
+                window->DrawList->PathLineTo(ImVec2(x, y_min));
+            }
+            if (v_hovered >= first && v_hovered < last)
+                hovered_column.Add(ImRect(x, y_max, x + 1.0f, ImMax(y_min, y_max + 1.0f)));
+        }
+        if (decimate)
+        {
+            window->DrawList->PathStroke(col_base, false);
+            // Highlight after stroking, AddLine() would stroke and clear the series path halfway through
+            if (hovered_column.Min.x <= hovered_column.Max.x)
+                window->DrawList->AddRectFilled(hovered_column.Min, hovered_column.Max, col_hovered);
+        }
+
+        for (int n = 0; !decimate && n < res_w; n++)
         {
             const float t1 = t0 + t_step;
             const int v1_idx = (int)(t0 * item_count + 0.5f);
@@ -7690,21 +7922,6 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
         RenderText(ImVec2(frame_bb.Max.x + style.ItemInnerSpacing.x, inner_bb.Min.y), label);
 }
 
-struct ImGuiPlotArrayGetterData
-{
-    const float* Values;
-    int Stride;
-
-    ImGuiPlotArrayGetterData(const float* values, int stride) { Values = values; Stride = stride; }
-};
-
-static float Plot_ArrayGetter(void* data, int idx)
-{
-    ImGuiPlotArrayGetterData* plot_data = (ImGuiPlotArrayGetterData*)data;
-    const float v = *(float*)(void*)((unsigned char*)plot_data->Values + (size_t)idx * plot_data->Stride);
-    return v;
-}
-
 void ImGui::PlotLines(const char* label, const float* values, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size, int stride)
 {
     ImGuiPlotArrayGetterData data(values, stride);
@@ -8208,6 +8425,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         password_font->ContainerAtlas = g.Font->ContainerAtlas;
         password_font->FallbackGlyph = glyph;
         password_font->FallbackAdvanceX = glyph->AdvanceX;
+        password_font->LayoutCache.Clear();
         IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
         PushFont(password_font);
     }
@@ -8423,7 +8641,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             {
                 // Filter pasted buffer
                 const int clipboard_len = (int)strlen(clipboard);
-                ImWchar* clipboard_filtered = (ImWchar*)ImGui::MemAlloc((clipboard_len+1) * sizeof(ImWchar));
+                ImWchar* clipboard_filtered = (ImWchar*)ImGui::MemAllocTransient((clipboard_len+1) * sizeof(ImWchar));
                 int clipboard_filtered_len = 0;
                 for (const char* s = clipboard; *s; )
                 {
@@ -11059,7 +11277,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                 ImGui::BulletText("Active: %d, WriteAccessed: %d", window->Active, window->WriteAccessed);
                 if (window->RootWindow != window) NodeWindow(window->RootWindow, "RootWindow");
                 if (window->DC.ChildWindows.Size > 0) NodeWindows(window->DC.ChildWindows, "ChildWindows");
-                ImGui::BulletText("Storage: %d bytes", window->StateStorage.Data.Size * (int)sizeof(ImGuiStorage::Pair));
+                ImGui::BulletText("Storage: %d bytes", window->StateStorage.Data.Size * (int)sizeof(ImGuiStorage::Pair) + window->StateStorage.Index.Size * (int)sizeof(int));
                 ImGui::TreePop();
             }
         };
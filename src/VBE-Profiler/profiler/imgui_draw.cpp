@@ -19,6 +19,12 @@
 #include <VBE-Profiler/profiler/imgui_internal.h>
 
 #include <stdio.h>      // vsnprintf, sscanf, printf
+#include <limits.h>     // INT_MAX
+#ifndef IMGUI_DISABLE_FONT_BUILD_THREADS
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
 #if !defined(alloca)
 #ifdef _WIN32
 #include <malloc.h>     // alloca
@@ -57,6 +63,26 @@
 // STB libraries implementation
 //-------------------------------------------------------------------------
 
+#ifndef IMGUI_DISABLE_FONT_BUILD_THREADS
+// Glyphs may be rasterized on worker threads during ImFontAtlas::Build(). Those pass a mutex as stb_truetype user data
+// so their allocations still go through ImGui::MemAlloc()/MemFree() (and the user allocator) one at a time.
+static void* ImFontAtlasBuildMemAlloc(size_t sz, void* user_data)
+{
+    if (!user_data)
+        return ImGui::MemAllocTransient(sz);
+    std::lock_guard<std::mutex> lock(*(std::mutex*)user_data);
+    return ImGui::MemAllocTransient(sz);
+}
+
+static void ImFontAtlasBuildMemFree(void* ptr, void* user_data)
+{
+    if (!user_data)
+        return ImGui::MemFree(ptr);
+    std::lock_guard<std::mutex> lock(*(std::mutex*)user_data);
+    ImGui::MemFree(ptr);
+}
+#endif
+
 //#define IMGUI_STB_NAMESPACE     ImGuiStb
 //#define IMGUI_DISABLE_STB_RECT_PACK_IMPLEMENTATION
 //#define IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
@@ -89,8 +115,13 @@ namespace IMGUI_STB_NAMESPACE
 #endif
 #include <VBE-Profiler/profiler/stb_rect_pack.h>
 
-#define STBTT_malloc(x,u)  ((void)(u), ImGui::MemAlloc(x))
+#ifndef IMGUI_DISABLE_FONT_BUILD_THREADS
+#define STBTT_malloc(x,u)  ImFontAtlasBuildMemAlloc(x,u)
+#define STBTT_free(x,u)    ImFontAtlasBuildMemFree(x,u)
+#else
+#define STBTT_malloc(x,u)  ((void)(u), ImGui::MemAllocTransient(x))
 #define STBTT_free(x,u)    ((void)(u), ImGui::MemFree(x))
+#endif
 #define STBTT_assert(x)    IM_ASSERT(x)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
 #define STBTT_STATIC
@@ -570,6 +601,100 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
     _IdxWritePtr += 6;
 }
 
+// Unit normals of the edges points[i] -> points[i+1] (the last point wraps to points[0]) for i in [0, count).
+// The SIMD versions perform exactly the same IEEE operations as the scalar code (no reciprocal estimates), so the output is bit-for-bit identical
+// as long as the compiler doesn't fuse the scalar multiply-adds (built with -ffp-contract=off). tests/polyline_normals checks it.
+static void ImComputeEdgeNormals(const ImVec2* points, int points_count, int count, ImVec2* out_normals)
+{
+    int i1 = 0;
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 neg_y = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, (int)0x80000000, 0));
+    for (; i1 + 2 < points_count && i1 + 2 <= count; i1 += 2)
+    {
+        __m128 diff = _mm_sub_ps(_mm_loadu_ps(&points[i1+1].x), _mm_loadu_ps(&points[i1].x));
+        __m128 sq = _mm_mul_ps(diff, diff);
+        __m128 d = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(d));
+        __m128 mask = _mm_cmpgt_ps(d, _mm_setzero_ps());
+        inv = _mm_or_ps(_mm_and_ps(mask, inv), _mm_andnot_ps(mask, one));
+        diff = _mm_mul_ps(diff, inv);
+        _mm_storeu_ps(&out_normals[i1].x, _mm_xor_ps(_mm_shuffle_ps(diff, diff, _MM_SHUFFLE(2,3,0,1)), neg_y));
+    }
+#elif defined(IMGUI_ENABLE_NEON) && defined(__aarch64__)
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t neg_y = { 1.0f, -1.0f, 1.0f, -1.0f };
+    for (; i1 + 2 < points_count && i1 + 2 <= count; i1 += 2)
+    {
+        float32x4_t diff = vsubq_f32(vld1q_f32(&points[i1+1].x), vld1q_f32(&points[i1].x));
+        float32x4_t sq = vmulq_f32(diff, diff);
+        float32x4_t d = vaddq_f32(sq, vrev64q_f32(sq));
+        float32x4_t inv = vbslq_f32(vcgtq_f32(d, vdupq_n_f32(0.0f)), vdivq_f32(one, vsqrtq_f32(d)), one);
+        diff = vmulq_f32(diff, inv);
+        vst1q_f32(&out_normals[i1].x, vmulq_f32(vrev64q_f32(diff), neg_y));
+    }
+#endif
+    for (; i1 < count; i1++)
+    {
+        const int i2 = (i1+1) == points_count ? 0 : i1+1;
+        ImVec2 diff = points[i2] - points[i1];
+        diff *= ImInvLength(diff, 1.0f);
+        out_normals[i1].x = diff.y;
+        out_normals[i1].y = -diff.x;
+    }
+}
+
+// Miter direction at each point: average of the normals of the edges before and after it (the first point wraps to the last edge), scaled so
+// that the offset stays at unit distance from both edges. Same bit-for-bit guarantee as ImComputeEdgeNormals().
+static void ImComputeAveragedNormals(const ImVec2* normals, int points_count, ImVec2* out_dm)
+{
+    int i2 = 0;
+    {
+        ImVec2 dm = (normals[points_count-1] + normals[0]) * 0.5f;
+        float dmr2 = dm.x*dm.x + dm.y*dm.y;
+        if (dmr2 > 0.000001f)
+        {
+            float scale = 1.0f / dmr2;
+            if (scale > 100.0f) scale = 100.0f;
+            dm *= scale;
+        }
+        out_dm[i2++] = dm;
+    }
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i2 + 2 <= points_count; i2 += 2)
+    {
+        __m128 dm = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&normals[i2-1].x), _mm_loadu_ps(&normals[i2].x)), half);
+        __m128 sq = _mm_mul_ps(dm, dm);
+        __m128 dmr2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+        __m128 scale = _mm_min_ps(_mm_div_ps(_mm_set1_ps(1.0f), dmr2), _mm_set1_ps(100.0f));
+        __m128 mask = _mm_cmpgt_ps(dmr2, _mm_set1_ps(0.000001f));
+        _mm_storeu_ps(&out_dm[i2].x, _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(dm, scale)), _mm_andnot_ps(mask, dm)));
+    }
+#elif defined(IMGUI_ENABLE_NEON) && defined(__aarch64__)
+    for (; i2 + 2 <= points_count; i2 += 2)
+    {
+        float32x4_t dm = vmulq_n_f32(vaddq_f32(vld1q_f32(&normals[i2-1].x), vld1q_f32(&normals[i2].x)), 0.5f);
+        float32x4_t sq = vmulq_f32(dm, dm);
+        float32x4_t dmr2 = vaddq_f32(sq, vrev64q_f32(sq));
+        float32x4_t scale = vminq_f32(vdivq_f32(vdupq_n_f32(1.0f), dmr2), vdupq_n_f32(100.0f));
+        vst1q_f32(&out_dm[i2].x, vbslq_f32(vcgtq_f32(dmr2, vdupq_n_f32(0.000001f)), vmulq_f32(dm, scale), dm));
+    }
+#endif
+    for (; i2 < points_count; i2++)
+    {
+        ImVec2 dm = (normals[i2-1] + normals[i2]) * 0.5f;
+        float dmr2 = dm.x*dm.x + dm.y*dm.y;
+        if (dmr2 > 0.000001f)
+        {
+            float scale = 1.0f / dmr2;
+            if (scale > 100.0f) scale = 100.0f;
+            dm *= scale;
+        }
+        out_dm[i2] = dm;
+    }
+}
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness, bool anti_aliased)
 {
@@ -596,19 +721,14 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         PrimReserve(idx_count, vtx_count);
 
         // Temporary buffer
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 5 : 3) * sizeof(ImVec2));
-        ImVec2* temp_points = temp_normals + points_count;
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 6 : 4) * sizeof(ImVec2));
+        ImVec2* temp_dm = temp_normals + points_count;
+        ImVec2* temp_points = temp_dm + points_count;
 
-        for (int i1 = 0; i1 < count; i1++)
-        {
-            const int i2 = (i1+1) == points_count ? 0 : i1+1;
-            ImVec2 diff = points[i2] - points[i1];
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i1].x = diff.y;
-            temp_normals[i1].y = -diff.x;
-        }
+        ImComputeEdgeNormals(points, points_count, count, temp_normals);
         if (!closed)
             temp_normals[points_count-1] = temp_normals[points_count-2];
+        ImComputeAveragedNormals(temp_normals, points_count, temp_dm);
 
         if (!thick_line)
         {
@@ -628,15 +748,7 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
                 unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+3;
 
                 // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
-                {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
-                }
-                dm *= AA_SIZE;
+                ImVec2 dm = temp_dm[i2] * AA_SIZE;
                 temp_points[i2*2+0] = points[i2] + dm;
                 temp_points[i2*2+1] = points[i2] - dm;
 
@@ -682,14 +794,7 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
                 unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+4;
 
                 // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
-                {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
-                }
+                const ImVec2& dm = temp_dm[i2];
                 ImVec2 dm_out = dm * (half_inner_thickness + AA_SIZE);
                 ImVec2 dm_in = dm * half_inner_thickness;
                 temp_points[i2*4+0] = points[i2] + dm_out;
@@ -721,6 +826,74 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         }
         _VtxCurrentIdx += (ImDrawIdx)vtx_count;
     }
+    else if (GImGui->Style.JoinedLines)
+    {
+        // Non Anti-aliased Stroke, joined strip: two vertices per point shared by the segments on both sides, mitered like the AA stroke
+        const float half_thickness = thickness * 0.5f;
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2));
+        ImVec2* temp_dm = temp_normals + points_count;
+        ImComputeEdgeNormals(points, points_count, count, temp_normals);
+        if (!closed)
+            temp_normals[points_count-1] = temp_normals[points_count-2];
+        ImComputeAveragedNormals(temp_normals, points_count, temp_dm);
+        if (!closed)
+        {
+            // Butt ends: no miter at the first and last points, the stroke stops flush with them like the unjoined stroke
+            temp_dm[0] = temp_normals[0];
+            temp_dm[points_count-1] = temp_normals[points_count-1];
+        }
+
+        // Miter limit: corners turning more than 90 degrees (spikes, reversals, zero length segments) would stick out or collapse.
+        // The strip is split there instead, both segments ending flush with the point like the unjoined stroke.
+        bool* temp_split = (bool*)alloca(points_count * sizeof(bool));
+        int split_count = 0;
+        for (int i = 0; i < points_count; i++)
+        {
+            temp_split[i] = false;
+            if (!closed && (i == 0 || i == points_count-1))
+                continue;
+            const ImVec2 dm = (temp_normals[i == 0 ? points_count-1 : i-1] + temp_normals[i]) * 0.5f;
+            temp_split[i] = (dm.x*dm.x + dm.y*dm.y) < 0.5f;
+            split_count += temp_split[i] ? 1 : 0;
+        }
+
+        const int idx_count = count*6;
+        const int vtx_count = (points_count + split_count)*2;
+        PrimReserve(idx_count, vtx_count);
+        for (int i = 0; i < points_count; i++)
+        {
+            if (temp_split[i])
+            {
+                // End of the segment before the point, then start of the one after it
+                const ImVec2 dm_in = temp_normals[i == 0 ? points_count-1 : i-1] * half_thickness;
+                _VtxWritePtr[0].pos = points[i] + dm_in; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+                _VtxWritePtr[1].pos = points[i] - dm_in; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+                _VtxWritePtr += 2;
+                const ImVec2 dm_out = temp_normals[i] * half_thickness;
+                _VtxWritePtr[0].pos = points[i] + dm_out; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+                _VtxWritePtr[1].pos = points[i] - dm_out; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+                _VtxWritePtr += 2;
+                continue;
+            }
+            const ImVec2 dm = temp_dm[i] * half_thickness;
+            _VtxWritePtr[0].pos = points[i] + dm; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+            _VtxWritePtr[1].pos = points[i] - dm; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+            _VtxWritePtr += 2;
+        }
+
+        // idx1: pair the segment leaves its first point from, idx2: pair it reaches its second point at
+        unsigned int idx1 = _VtxCurrentIdx + (temp_split[0] ? 2 : 0);
+        for (int i1 = 0; i1 < count; i1++)
+        {
+            const int i2 = (i1+1) == points_count ? 0 : i1+1;
+            unsigned int idx2 = (i2 == 0) ? _VtxCurrentIdx : idx1+2;
+            _IdxWritePtr[0] = (ImDrawIdx)(idx1); _IdxWritePtr[1] = (ImDrawIdx)(idx2); _IdxWritePtr[2] = (ImDrawIdx)(idx2+1);
+            _IdxWritePtr[3] = (ImDrawIdx)(idx1); _IdxWritePtr[4] = (ImDrawIdx)(idx2+1); _IdxWritePtr[5] = (ImDrawIdx)(idx1+1);
+            _IdxWritePtr += 6;
+            idx1 = idx2 + (temp_split[i2] ? 2 : 0);
+        }
+        _VtxCurrentIdx += (ImDrawIdx)vtx_count;
+    }
     else
     {
         // Non Anti-aliased Stroke
@@ -777,31 +950,15 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
         }
 
         // Compute normals
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2));
-        for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
-        {
-            const ImVec2& p0 = points[i0];
-            const ImVec2& p1 = points[i1];
-            ImVec2 diff = p1 - p0;
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i0].x = diff.y;
-            temp_normals[i0].y = -diff.x;
-        }
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2));
+        ImVec2* temp_dm = temp_normals + points_count;
+        ImComputeEdgeNormals(points, points_count, points_count, temp_normals);
+        ImComputeAveragedNormals(temp_normals, points_count, temp_dm);
 
         for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
         {
             // Average normals
-            const ImVec2& n0 = temp_normals[i0];
-            const ImVec2& n1 = temp_normals[i1];
-            ImVec2 dm = (n0 + n1) * 0.5f;
-            float dmr2 = dm.x*dm.x + dm.y*dm.y;
-            if (dmr2 > 0.000001f)
-            {
-                float scale = 1.0f / dmr2;
-                if (scale > 100.0f) scale = 100.0f;
-                dm *= scale;
-            }
-            dm *= AA_SIZE * 0.5f;
+            ImVec2 dm = temp_dm[i1] * (AA_SIZE * 0.5f);
 
             // Add vertices
             _VtxWritePtr[0].pos = (points[i1] - dm); _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;        // Inner
@@ -1346,17 +1503,23 @@ static const ImVec2 FONT_ATLAS_DEFAULT_TEX_CURSOR_DATA[ImGuiMouseCursor_Count_][
 };
 
 
+static void ImFontAtlasBuildDynamicClear(ImFontAtlas* atlas);
+
 ImFontAtlas::ImFontAtlas()
 {
     TexID = NULL;
     TexDesiredWidth = 0;
     TexGlyphPadding = 1;
+    BuildThreadsCount = 0;
+    DynamicGlyphs = false;
     TexPixelsAlpha8 = NULL;
     TexPixelsRGBA32 = NULL;
     TexWidth = TexHeight = 0;
     TexUvWhitePixel = ImVec2(0, 0);
     for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
         CustomRectIds[n] = -1;
+    TexDirtyX0 = TexDirtyY0 = TexDirtyX1 = TexDirtyY1 = 0;
+    DynamicBuildData = NULL;
 }
 
 ImFontAtlas::~ImFontAtlas()
@@ -1366,6 +1529,8 @@ ImFontAtlas::~ImFontAtlas()
 
 void    ImFontAtlas::ClearInputData()
 {
+    // Glyphs not rasterized yet will use the fallback glyph from now on
+    ImFontAtlasBuildDynamicClear(this);
     for (int i = 0; i < ConfigData.Size; i++)
         if (ConfigData[i].FontData && ConfigData[i].FontDataOwnedByAtlas)
         {
@@ -1388,6 +1553,7 @@ void    ImFontAtlas::ClearInputData()
 
 void    ImFontAtlas::ClearTexData()
 {
+    ImFontAtlasBuildDynamicClear(this);
     if (TexPixelsAlpha8)
         ImGui::MemFree(TexPixelsAlpha8);
     if (TexPixelsRGBA32)
@@ -1450,6 +1616,254 @@ void    ImFontAtlas::GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_wid
     if (out_bytes_per_pixel) *out_bytes_per_pixel = 4;
 }
 
+bool    ImFontAtlas::GetTexDirtyRect(int* out_x, int* out_y, int* out_w, int* out_h) const
+{
+    if (TexDirtyX1 <= TexDirtyX0 || TexDirtyY1 <= TexDirtyY0)
+        return false;
+    *out_x = TexDirtyX0;
+    *out_y = TexDirtyY0;
+    *out_w = TexDirtyX1 - TexDirtyX0;
+    *out_h = TexDirtyY1 - TexDirtyY0;
+    return true;
+}
+
+// Built atlas cache. Native endianness and layout: this is meant as a local cache or build product, not as an interchange format.
+static const char   FONT_ATLAS_CACHE_MAGIC[8] = { 'I','M','F','A','T','L','S', 2 };
+
+struct ImFontAtlasCacheHeader
+{
+    char    Magic[8];
+    char    Version[16];
+    int     GlyphSize;          // sizeof(ImFontGlyph)
+    int     TexWidth, TexHeight;
+    int     TexDesiredWidth, TexGlyphPadding;
+    int     FontsCount;
+    int     CustomRectsCount;
+    int     CustomRectIds[IM_ARRAYSIZE(((ImFontAtlas*)0)->CustomRectIds)];
+    ImU32   ConfigHash;         // Of every input the fonts were built from, see ImFontAtlasCacheConfigHash()
+};
+
+struct ImFontAtlasCacheFont
+{
+    float   FontSize, Scale;
+    ImVec2  DisplayOffset;
+    float   Ascent, Descent;
+    int     FallbackChar;
+    int     MetricsTotalSurface;
+    int     GlyphsCount;
+};
+
+struct ImFontAtlasCacheRect
+{
+    unsigned int    ID;
+    unsigned short  Width, Height, X, Y;
+    float           GlyphAdvanceX;
+    ImVec2          GlyphOffset;
+    int             FontIndex;  // -1 for regular rectangles
+};
+
+// Fonts added to the atlas (data, size, ranges, oversampling...): a cache built from other inputs would silently replace them
+static ImU32 ImFontAtlasCacheConfigHash(const ImFontAtlas* atlas)
+{
+    ImU32 hash = 0;
+    for (int i = 0; i < atlas->ConfigData.Size; i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[i];
+        const int merge_mode = cfg.MergeMode ? 1 : 0, pixel_snap_h = cfg.PixelSnapH ? 1 : 0;
+        hash = ImHash(cfg.FontData, cfg.FontDataSize, hash);
+        hash = ImHash(&cfg.FontNo, (int)sizeof(cfg.FontNo), hash);
+        hash = ImHash(&cfg.SizePixels, (int)sizeof(cfg.SizePixels), hash);
+        hash = ImHash(&cfg.OversampleH, (int)sizeof(cfg.OversampleH), hash);
+        hash = ImHash(&cfg.OversampleV, (int)sizeof(cfg.OversampleV), hash);
+        hash = ImHash(&pixel_snap_h, (int)sizeof(pixel_snap_h), hash);
+        hash = ImHash(&cfg.GlyphExtraSpacing, (int)sizeof(cfg.GlyphExtraSpacing), hash);
+        hash = ImHash(&cfg.GlyphOffset, (int)sizeof(cfg.GlyphOffset), hash);
+        hash = ImHash(&merge_mode, (int)sizeof(merge_mode), hash);
+        hash = ImHash(&cfg.RasterizerFlags, (int)sizeof(cfg.RasterizerFlags), hash);
+        hash = ImHash(&cfg.RasterizerMultiply, (int)sizeof(cfg.RasterizerMultiply), hash);
+        const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : ((ImFontAtlas*)atlas)->GetGlyphRangesDefault(); // Build() resolves NULL to these
+        int ranges_count = 0;
+        while (ranges[ranges_count])
+            ranges_count++;
+        hash = ImHash(&ranges_count, (int)sizeof(ranges_count), hash);
+        if (ranges_count > 0)
+            hash = ImHash(ranges, ranges_count * (int)sizeof(ImWchar), hash);
+    }
+    return hash;
+}
+
+static void ImFontAtlasCacheWrite(ImVector<unsigned char>& buf, const void* data, int data_size)
+{
+    const int offset = buf.Size;
+    buf.resize(offset + data_size);
+    memcpy(buf.Data + offset, data, (size_t)data_size);
+}
+
+static const void* ImFontAtlasCacheRead(const unsigned char*& p, const unsigned char* p_end, int data_size)
+{
+    if (data_size < 0 || p_end - p < data_size)
+        return NULL;
+    const void* data = p;
+    p += data_size;
+    return data;
+}
+
+bool    ImFontAtlas::SaveBuiltData(const char* filename) const
+{
+    if (filename == NULL || TexPixelsAlpha8 == NULL || DynamicBuildData != NULL) // A dynamic atlas only holds the glyphs used so far
+        return false;
+
+    ImFontAtlasCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, FONT_ATLAS_CACHE_MAGIC, sizeof(header.Magic));
+    ImStrncpy(header.Version, IMGUI_VERSION, IM_ARRAYSIZE(header.Version));
+    header.GlyphSize = (int)sizeof(ImFontGlyph);
+    header.TexWidth = TexWidth;
+    header.TexHeight = TexHeight;
+    header.TexDesiredWidth = TexDesiredWidth;
+    header.TexGlyphPadding = TexGlyphPadding;
+    header.FontsCount = Fonts.Size;
+    header.CustomRectsCount = CustomRects.Size;
+    for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
+        header.CustomRectIds[n] = CustomRectIds[n];
+    header.ConfigHash = ImFontAtlasCacheConfigHash(this);
+
+    ImVector<unsigned char> buf;
+    ImFontAtlasCacheWrite(buf, &header, (int)sizeof(header));
+    ImFontAtlasCacheWrite(buf, TexPixelsAlpha8, TexWidth * TexHeight);
+    for (int i = 0; i < Fonts.Size; i++)
+    {
+        const ImFont* font = Fonts[i];
+        ImFontAtlasCacheFont font_data = ImFontAtlasCacheFont();
+        font_data.FontSize = font->FontSize;
+        font_data.Scale = font->Scale;
+        font_data.DisplayOffset = font->DisplayOffset;
+        font_data.Ascent = font->Ascent;
+        font_data.Descent = font->Descent;
+        font_data.FallbackChar = (int)font->FallbackChar;
+        font_data.MetricsTotalSurface = font->MetricsTotalSurface;
+        font_data.GlyphsCount = font->Glyphs.Size;
+        ImFontAtlasCacheWrite(buf, &font_data, (int)sizeof(font_data));
+        ImFontAtlasCacheWrite(buf, font->Glyphs.Data, font->Glyphs.Size * (int)sizeof(ImFontGlyph));
+    }
+    for (int i = 0; i < CustomRects.Size; i++)
+    {
+        const CustomRect& r = CustomRects[i];
+        ImFontAtlasCacheRect rect_data = ImFontAtlasCacheRect();
+        rect_data.ID = r.ID;
+        rect_data.Width = r.Width; rect_data.Height = r.Height;
+        rect_data.X = r.X; rect_data.Y = r.Y;
+        rect_data.GlyphAdvanceX = r.GlyphAdvanceX;
+        rect_data.GlyphOffset = r.GlyphOffset;
+        rect_data.FontIndex = -1;
+        for (int font_i = 0; font_i < Fonts.Size; font_i++)
+            if (Fonts[font_i] == r.Font)
+                rect_data.FontIndex = font_i;
+        ImFontAtlasCacheWrite(buf, &rect_data, (int)sizeof(rect_data));
+    }
+
+    FILE* f = ImFileOpen(filename, "wb");
+    if (f == NULL)
+        return false;
+    const bool ok = fwrite(buf.Data, 1, (size_t)buf.Size, f) == (size_t)buf.Size;
+    fclose(f);
+    return ok;
+}
+
+bool    ImFontAtlas::LoadBuiltData(const char* filename)
+{
+    if (filename == NULL)
+        return false;
+    int data_size = 0;
+    void* data = ImFileLoadToMemory(filename, "rb", &data_size, 0);
+    if (data == NULL)
+        return false;
+    const bool ok = LoadBuiltDataFromMemory(data, data_size);
+    ImGui::MemFree(data);
+    return ok;
+}
+
+bool    ImFontAtlas::LoadBuiltDataFromMemory(const void* data, int data_size)
+{
+    if (DynamicGlyphs)
+        return false;
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* p_end = p + data_size;
+
+    // Validate everything before touching the atlas
+    const ImFontAtlasCacheHeader* header = (const ImFontAtlasCacheHeader*)ImFontAtlasCacheRead(p, p_end, (int)sizeof(ImFontAtlasCacheHeader));
+    if (!header || memcmp(header->Magic, FONT_ATLAS_CACHE_MAGIC, sizeof(header->Magic)) != 0 || strncmp(header->Version, IMGUI_VERSION, IM_ARRAYSIZE(header->Version)) != 0)
+        return false;
+    if (header->GlyphSize != (int)sizeof(ImFontGlyph) || header->TexDesiredWidth != TexDesiredWidth || header->TexGlyphPadding != TexGlyphPadding)
+        return false;
+    if (header->TexWidth <= 0 || header->TexHeight <= 0 || header->TexWidth > INT_MAX / header->TexHeight || header->FontsCount <= 0 || header->CustomRectsCount < 0)
+        return false;
+    if (header->ConfigHash != ImFontAtlasCacheConfigHash(this))
+        return false;
+    const unsigned char* pixels = (const unsigned char*)ImFontAtlasCacheRead(p, p_end, header->TexWidth * header->TexHeight);
+    const unsigned char* fonts_begin = p;
+    for (int i = 0; pixels && i < header->FontsCount; i++)
+    {
+        const ImFontAtlasCacheFont* font_data = (const ImFontAtlasCacheFont*)ImFontAtlasCacheRead(p, p_end, (int)sizeof(ImFontAtlasCacheFont));
+        if (!font_data || font_data->GlyphsCount <= 0 || !ImFontAtlasCacheRead(p, p_end, font_data->GlyphsCount * (int)sizeof(ImFontGlyph)))
+            return false;
+    }
+    const ImFontAtlasCacheRect* rects = (const ImFontAtlasCacheRect*)ImFontAtlasCacheRead(p, p_end, header->CustomRectsCount * (int)sizeof(ImFontAtlasCacheRect));
+    if (!pixels || !rects || p != p_end)
+        return false;
+    for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
+        if (header->CustomRectIds[n] >= header->CustomRectsCount)
+            return false;
+    if (header->CustomRectIds[0] < 0)
+        return false;
+
+    // Replace atlas contents
+    Clear();
+    TexWidth = header->TexWidth;
+    TexHeight = header->TexHeight;
+    TexPixelsAlpha8 = (unsigned char*)ImGui::MemAlloc((size_t)(TexWidth * TexHeight));
+    memcpy(TexPixelsAlpha8, pixels, (size_t)(TexWidth * TexHeight));
+
+    p = fonts_begin;
+    for (int i = 0; i < header->FontsCount; i++)
+    {
+        const ImFontAtlasCacheFont* font_data = (const ImFontAtlasCacheFont*)ImFontAtlasCacheRead(p, p_end, (int)sizeof(ImFontAtlasCacheFont));
+        const ImFontGlyph* glyphs = (const ImFontGlyph*)ImFontAtlasCacheRead(p, p_end, font_data->GlyphsCount * (int)sizeof(ImFontGlyph));
+        ImFont* font = (ImFont*)ImGui::MemAlloc(sizeof(ImFont));
+        IM_PLACEMENT_NEW(font) ImFont();
+        Fonts.push_back(font);
+        font->FontSize = font_data->FontSize;
+        font->Scale = font_data->Scale;
+        font->DisplayOffset = font_data->DisplayOffset;
+        font->Ascent = font_data->Ascent;
+        font->Descent = font_data->Descent;
+        font->FallbackChar = (ImWchar)font_data->FallbackChar;
+        font->MetricsTotalSurface = font_data->MetricsTotalSurface;
+        font->ContainerAtlas = this;
+        font->Glyphs.resize(font_data->GlyphsCount);
+        memcpy(font->Glyphs.Data, glyphs, (size_t)font_data->GlyphsCount * sizeof(ImFontGlyph));
+        font->BuildLookupTable();
+    }
+
+    CustomRects.resize(header->CustomRectsCount);
+    for (int i = 0; i < header->CustomRectsCount; i++)
+    {
+        const ImFontAtlasCacheRect& rect_data = rects[i];
+        CustomRect& r = CustomRects[i];
+        r.ID = rect_data.ID;
+        r.Width = rect_data.Width; r.Height = rect_data.Height;
+        r.X = rect_data.X; r.Y = rect_data.Y;
+        r.GlyphAdvanceX = rect_data.GlyphAdvanceX;
+        r.GlyphOffset = rect_data.GlyphOffset;
+        r.Font = (rect_data.FontIndex >= 0 && rect_data.FontIndex < Fonts.Size) ? Fonts[rect_data.FontIndex] : NULL;
+    }
+    for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
+        CustomRectIds[n] = header->CustomRectIds[n];
+
+    ImFontAtlasBuildSetupDefaultTexData(this);
+    return true;
+}
+
 ImFont* ImFontAtlas::AddFont(const ImFontConfig* font_cfg)
 {
     IM_ASSERT(font_cfg->FontData != NULL && font_cfg->FontDataSize > 0);
@@ -1630,6 +2044,281 @@ void    ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsig
             data[i] = table[data[i]];
 }
 
+struct ImFontTempBuildData
+{
+    stbtt_fontinfo      FontInfo;
+    stbrp_rect*         Rects;
+    int                 RectsCount;
+    stbtt_pack_range*   Ranges;
+    int                 RangesCount;
+};
+
+#ifndef IMGUI_DISABLE_FONT_BUILD_THREADS
+// Slice of a packed range, rasterized as a unit by one of the build threads
+struct ImFontBuildRenderJob
+{
+    int                 InputIndex;
+    stbtt_pack_range    Range;
+    stbrp_rect*         Rects;
+};
+#endif
+
+// Returns false when the build is too small to be worth threading (or threads are disabled): the caller then renders serially
+static bool ImFontAtlasBuildRenderRangesParallel(ImFontAtlas* atlas, const stbtt_pack_context* spc, const ImFontTempBuildData* tmp_array, int total_glyphs_count)
+{
+#ifdef IMGUI_DISABLE_FONT_BUILD_THREADS
+    (void)atlas; (void)spc; (void)tmp_array; (void)total_glyphs_count;
+    return false;
+#else
+    const int GLYPHS_PER_JOB = 256;
+    const int MIN_GLYPHS_COUNT = 2048;
+    const int MAX_THREADS_COUNT = 64;
+    int threads_count = (atlas->BuildThreadsCount > 0) ? atlas->BuildThreadsCount : (int)std::thread::hardware_concurrency();
+    if (threads_count <= 1 || total_glyphs_count < MIN_GLYPHS_COUNT)
+        return false;
+
+    ImVector<ImFontBuildRenderJob> jobs;
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontTempBuildData& tmp = tmp_array[input_i];
+        stbrp_rect* rects = tmp.Rects;
+        for (int i = 0; i < tmp.RangesCount; i++)
+        {
+            const stbtt_pack_range& range = tmp.Ranges[i];
+            for (int char_idx = 0; char_idx < range.num_chars; char_idx += GLYPHS_PER_JOB)
+            {
+                ImFontBuildRenderJob job;
+                job.InputIndex = input_i;
+                job.Range = range;
+                job.Range.first_unicode_codepoint_in_range += char_idx;
+                job.Range.num_chars = ImMin(GLYPHS_PER_JOB, range.num_chars - char_idx);
+                job.Range.chardata_for_range += char_idx;
+                job.Rects = rects + char_idx;
+                jobs.push_back(job);
+            }
+            rects += range.num_chars;
+        }
+    }
+
+    // The calling thread works too. Each worker has its own pack context copy since rendering overwrites its oversampling settings.
+    std::mutex alloc_mutex;
+    std::atomic<int> next_job(0);
+    auto worker = [&]()
+    {
+        stbtt_pack_context worker_spc = *spc;
+        for (int job_i = next_job++; job_i < jobs.Size; job_i = next_job++)
+        {
+            ImFontBuildRenderJob& job = jobs[job_i];
+            stbtt_fontinfo font_info = tmp_array[job.InputIndex].FontInfo;
+            font_info.userdata = &alloc_mutex;
+            stbtt_PackFontRangesRenderIntoRects(&worker_spc, &font_info, &job.Range, 1, job.Rects);
+        }
+    };
+    threads_count = ImMin(ImMin(threads_count, jobs.Size), MAX_THREADS_COUNT);
+    std::thread threads[MAX_THREADS_COUNT];
+    for (int n = 1; n < threads_count; n++)
+        threads[n] = std::thread(worker);
+    worker();
+    for (int n = 1; n < threads_count; n++)
+        threads[n].join();
+    return true;
+#endif
+}
+
+// Dynamic atlas: the font info and pack context outlive Build() so glyphs can be packed into the remaining texture space when first requested
+struct ImFontAtlasDynamicData
+{
+    stbtt_pack_context          PackContext;
+    ImVector<stbtt_fontinfo>    FontInfos;      // Parallel to ImFontAtlas::ConfigData
+};
+
+// ImFont::IndexLookup value for glyphs that have an advance but haven't been rasterized yet
+static const unsigned short FONT_GLYPH_INDEX_PENDING = 0xFFFE;
+
+static void ImFontAtlasBuildDynamicClear(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamicData* data = (ImFontAtlasDynamicData*)atlas->DynamicBuildData;
+    if (data == NULL)
+        return;
+    stbtt_PackEnd(&data->PackContext);
+    data->~ImFontAtlasDynamicData();
+    ImGui::MemFree(data);
+    atlas->DynamicBuildData = NULL;
+    atlas->ClearTexDirtyRect();
+}
+
+static bool ImFontAtlasBuildDynamicWithStbTruetype(ImFontAtlas* atlas, int total_glyphs_count)
+{
+    // The texture only has to hold the glyphs actually drawn, which is usually a small subset of large ranges
+    atlas->TexWidth = (atlas->TexDesiredWidth > 0) ? atlas->TexDesiredWidth : (total_glyphs_count > 1000) ? 1024 : 512;
+    atlas->TexHeight = atlas->TexWidth;
+
+    ImFontAtlasDynamicData* data = (ImFontAtlasDynamicData*)ImGui::MemAlloc(sizeof(ImFontAtlasDynamicData));
+    IM_PLACEMENT_NEW(data) ImFontAtlasDynamicData();
+    data->FontInfos.resize(atlas->ConfigData.Size);
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        ImFontConfig& cfg = atlas->ConfigData[input_i];
+        stbtt_fontinfo& font_info = data->FontInfos[input_i];
+        IM_ASSERT(cfg.DstFont && (!cfg.DstFont->IsLoaded() || cfg.DstFont->ContainerAtlas == atlas));
+
+        const int font_offset = stbtt_GetFontOffsetForIndex((unsigned char*)cfg.FontData, cfg.FontNo);
+        IM_ASSERT(font_offset >= 0);
+        if (!stbtt_InitFont(&font_info, (unsigned char*)cfg.FontData, font_offset))
+        {
+            data->~ImFontAtlasDynamicData();
+            ImGui::MemFree(data);
+            return false;
+        }
+        font_info.userdata = NULL;
+    }
+    atlas->DynamicBuildData = data;
+
+    atlas->TexPixelsAlpha8 = (unsigned char*)ImGui::MemAlloc(atlas->TexWidth * atlas->TexHeight);
+    memset(atlas->TexPixelsAlpha8, 0, atlas->TexWidth * atlas->TexHeight);
+    stbtt_pack_context& spc = data->PackContext;
+    memset(&spc, 0, sizeof(spc));
+    stbtt_PackBegin(&spc, atlas->TexPixelsAlpha8, atlas->TexWidth, atlas->TexHeight, 0, atlas->TexGlyphPadding, NULL);
+    ImFontAtlasBuildPackCustomRects(atlas, spc.pack_info);
+
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        ImFontConfig& cfg = atlas->ConfigData[input_i];
+        const stbtt_fontinfo& font_info = data->FontInfos[input_i];
+        const float font_scale = stbtt_ScaleForPixelHeight(&font_info, cfg.SizePixels);
+        int unscaled_ascent, unscaled_descent, unscaled_line_gap;
+        stbtt_GetFontVMetrics(&font_info, &unscaled_ascent, &unscaled_descent, &unscaled_line_gap);
+        ImFontAtlasBuildSetupFont(atlas, cfg.DstFont, &cfg, unscaled_ascent * font_scale, unscaled_descent * font_scale);
+    }
+
+    // BuildLookupTable() registers the advance of every glyph in the ranges. The few glyphs it rasterizes (space, fallback) are part of the initial upload.
+    ImFontAtlasBuildFinish(atlas);
+    atlas->ClearTexDirtyRect();
+    return true;
+}
+
+void ImFontAtlasBuildDynamicRegisterGlyphs(ImFontAtlas* atlas, ImFont* font)
+{
+    ImFontAtlasDynamicData* data = (ImFontAtlasDynamicData*)atlas->DynamicBuildData;
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[input_i];
+        if (cfg.DstFont != font)
+            continue;
+        const stbtt_fontinfo& font_info = data->FontInfos[input_i];
+        const float font_scale = stbtt_ScaleForPixelHeight(&font_info, cfg.SizePixels);
+        for (const ImWchar* in_range = cfg.GlyphRanges; in_range[0] && in_range[1]; in_range += 2)
+        {
+            font->GrowIndex(in_range[1] + 1);
+            for (int codepoint = in_range[0]; codepoint <= in_range[1]; codepoint++)
+            {
+                if (font->IndexLookup[codepoint] != (unsigned short)-1) // Already built, or provided by a previous input when merging
+                    continue;
+
+                // Same advance AddGlyph() will compute once the glyph is rasterized
+                int advance, lsb;
+                stbtt_GetCodepointHMetrics(&font_info, codepoint, &advance, &lsb);
+                float advance_x = font_scale * advance + font->ConfigData->GlyphExtraSpacing.x;
+                if (font->ConfigData->PixelSnapH)
+                    advance_x = (float)(int)(advance_x + 0.5f);
+                font->IndexAdvanceX[codepoint] = advance_x;
+                font->IndexLookup[codepoint] = FONT_GLYPH_INDEX_PENDING;
+            }
+        }
+    }
+}
+
+const ImFontGlyph* ImFontAtlasBuildDynamicGlyph(ImFontAtlas* atlas, ImFont* font, ImWchar codepoint)
+{
+    IM_ASSERT(codepoint < font->IndexLookup.Size && font->IndexLookup[codepoint] == FONT_GLYPH_INDEX_PENDING);
+
+    // Same input priority as when merging fonts in a regular build: the first one covering the codepoint
+    ImFontAtlasDynamicData* data = (ImFontAtlasDynamicData*)atlas->DynamicBuildData;
+    int input_i = 0;
+    for (; data && input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[input_i];
+        if (cfg.DstFont != font)
+            continue;
+        const ImWchar* in_range = cfg.GlyphRanges;
+        for (; in_range[0] && in_range[1]; in_range += 2)
+            if (codepoint >= in_range[0] && codepoint <= in_range[1])
+                break;
+        if (in_range[0] && in_range[1])
+            break;
+    }
+
+    stbtt_packedchar pc;
+    stbtt_pack_range range;
+    stbrp_rect rect;
+    memset(&pc, 0, sizeof(pc));
+    memset(&range, 0, sizeof(range));
+    memset(&rect, 0, sizeof(rect));
+    if (data && input_i < atlas->ConfigData.Size && font->Glyphs.Size < FONT_GLYPH_INDEX_PENDING)
+    {
+        ImFontConfig& cfg = atlas->ConfigData[input_i];
+        stbtt_pack_context& spc = data->PackContext;
+        range.font_size = cfg.SizePixels;
+        range.first_unicode_codepoint_in_range = codepoint;
+        range.num_chars = 1;
+        range.chardata_for_range = &pc;
+        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+        stbtt_PackFontRangesGatherRects(&spc, &data->FontInfos[input_i], &range, 1, &rect);
+        stbrp_pack_rects((stbrp_context*)spc.pack_info, &rect, 1);
+    }
+    if (!rect.was_packed)
+    {
+        // Texture full (or input data cleared): draw the fallback glyph from now on
+        font->IndexLookup[codepoint] = (unsigned short)-1;
+        font->IndexAdvanceX[codepoint] = font->FallbackAdvanceX;
+        font->LayoutCache.Stale = true;
+        return font->FallbackGlyph;
+    }
+
+    ImFontConfig& cfg = atlas->ConfigData[input_i];
+    stbtt_pack_context& spc = data->PackContext;
+    stbtt_PackFontRangesRenderIntoRects(&spc, &data->FontInfos[input_i], &range, 1, &rect);
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, spc.pixels, rect.x, rect.y, rect.w, rect.h, spc.stride_in_bytes);
+    }
+    if (atlas->TexPixelsRGBA32)
+        for (int y = rect.y; y < rect.y + rect.h; y++)
+        {
+            const unsigned char* src = atlas->TexPixelsAlpha8 + y * atlas->TexWidth + rect.x;
+            unsigned int* dst = atlas->TexPixelsRGBA32 + y * atlas->TexWidth + rect.x;
+            for (int n = rect.w; n > 0; n--)
+                *dst++ = IM_COL32(255, 255, 255, (unsigned int)(*src++));
+        }
+    if (atlas->TexDirtyX1 <= atlas->TexDirtyX0 || atlas->TexDirtyY1 <= atlas->TexDirtyY0)
+    {
+        atlas->TexDirtyX0 = rect.x; atlas->TexDirtyY0 = rect.y;
+        atlas->TexDirtyX1 = rect.x + rect.w; atlas->TexDirtyY1 = rect.y + rect.h;
+    }
+    else
+    {
+        atlas->TexDirtyX0 = ImMin(atlas->TexDirtyX0, (int)rect.x); atlas->TexDirtyY0 = ImMin(atlas->TexDirtyY0, (int)rect.y);
+        atlas->TexDirtyX1 = ImMax(atlas->TexDirtyX1, (int)(rect.x + rect.w)); atlas->TexDirtyY1 = ImMax(atlas->TexDirtyY1, (int)(rect.y + rect.h));
+    }
+
+    const float off_x = cfg.GlyphOffset.x;
+    const float off_y = cfg.GlyphOffset.y + (float)(int)(font->Ascent + 0.5f);
+    stbtt_aligned_quad q;
+    float dummy_x = 0.0f, dummy_y = 0.0f;
+    stbtt_GetPackedQuad(&pc, atlas->TexWidth, atlas->TexHeight, 0, &dummy_x, &dummy_y, &q, 0);
+    font->AddGlyph(codepoint, q.x0 + off_x, q.y0 + off_y, q.x1 + off_x, q.y1 + off_y, q.s0, q.t0, q.s1, q.t1, pc.xadvance);
+    font->IndexAdvanceX[codepoint] = font->Glyphs.back().AdvanceX;
+    font->IndexLookup[codepoint] = (unsigned short)(font->Glyphs.Size - 1);
+
+    // Glyphs storage may have moved
+    const unsigned short fallback_index = (font->FallbackChar < font->IndexLookup.Size) ? font->IndexLookup[font->FallbackChar] : (unsigned short)-1;
+    if (font->FallbackGlyph && fallback_index < FONT_GLYPH_INDEX_PENDING)
+        font->FallbackGlyph = &font->Glyphs[fallback_index];
+    return &font->Glyphs.back();
+}
+
 bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
@@ -1652,6 +2341,8 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         for (const ImWchar* in_range = cfg.GlyphRanges; in_range[0] && in_range[1]; in_range += 2, total_ranges_count++)
             total_glyphs_count += (in_range[1] - in_range[0]) + 1;
     }
+    if (atlas->DynamicGlyphs)
+        return ImFontAtlasBuildDynamicWithStbTruetype(atlas, total_glyphs_count);
 
     // We need a width for the skyline algorithm. Using a dumb heuristic here to decide of width. User can override TexDesiredWidth and TexGlyphPadding if they wish.
     // Width doesn't really matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
@@ -1668,14 +2359,6 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     ImFontAtlasBuildPackCustomRects(atlas, spc.pack_info);
 
     // Initialize font information (so we can error without any cleanup)
-    struct ImFontTempBuildData
-    {
-        stbtt_fontinfo      FontInfo;
-        stbrp_rect*         Rects;
-        int                 RectsCount;
-        stbtt_pack_range*   Ranges;
-        int                 RangesCount;
-    };
     ImFontTempBuildData* tmp_array = (ImFontTempBuildData*)ImGui::MemAlloc((size_t)atlas->ConfigData.Size * sizeof(ImFontTempBuildData));
     for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
     {
@@ -1690,6 +2373,7 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
             ImGui::MemFree(tmp_array);
             return false;
         }
+        tmp.FontInfo.userdata = NULL; // Passed to our allocation hooks, not set by stbtt_InitFont()
     }
 
     // Allocate packing character data and flag packed characters buffer as non-packed (x0=y0=x1=y1=0)
@@ -1752,12 +2436,21 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     spc.height = atlas->TexHeight;
 
     // Second pass: render font characters
+    // Every glyph owns a distinct packed rectangle, so large builds rasterize slices of the ranges in parallel. The output is identical to the serial build.
+    if (!ImFontAtlasBuildRenderRangesParallel(atlas, &spc, tmp_array, total_glyphs_count))
+    {
+        for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+        {
+            ImFontConfig& cfg = atlas->ConfigData[input_i];
+            ImFontTempBuildData& tmp = tmp_array[input_i];
+            stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+            stbtt_PackFontRangesRenderIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+        }
+    }
     for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
     {
         ImFontConfig& cfg = atlas->ConfigData[input_i];
         ImFontTempBuildData& tmp = tmp_array[input_i];
-        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
-        stbtt_PackFontRangesRenderIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
         if (cfg.RasterizerMultiply != 1.0f)
         {
             unsigned char multiply_table[256];
@@ -1887,6 +2580,16 @@ static void ImFontAtlasBuildRenderDefaultTexData(ImFontAtlas* atlas)
             atlas->TexPixelsAlpha8[offset0] = FONT_ATLAS_DEFAULT_TEX_DATA_PIXELS[n] == '.' ? 0xFF : 0x00;
             atlas->TexPixelsAlpha8[offset1] = FONT_ATLAS_DEFAULT_TEX_DATA_PIXELS[n] == 'X' ? 0xFF : 0x00;
         }
+    ImFontAtlasBuildSetupDefaultTexData(atlas);
+}
+
+// Setup white pixel UV and mouse cursors from the already rendered custom data block
+void ImFontAtlasBuildSetupDefaultTexData(ImFontAtlas* atlas)
+{
+    IM_ASSERT(atlas->CustomRectIds[0] >= 0);
+    const ImFontAtlas::CustomRect& r = atlas->CustomRects[atlas->CustomRectIds[0]];
+    IM_ASSERT(r.IsPacked());
+
     const ImVec2 tex_uv_scale(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
     atlas->TexUvWhitePixel = ImVec2((r.X + 0.5f) * tex_uv_scale.x, (r.Y + 0.5f) * tex_uv_scale.y);
 
@@ -2122,6 +2825,7 @@ ImFont::~ImFont()
 
 void    ImFont::ClearOutputData()
 {
+    LayoutCache.Clear();
     FontSize = 0.0f;
     Glyphs.clear();
     IndexAdvanceX.clear();
@@ -2141,7 +2845,8 @@ void ImFont::BuildLookupTable()
     for (int i = 0; i != Glyphs.Size; i++)
         max_codepoint = ImMax(max_codepoint, (int)Glyphs[i].Codepoint);
 
-    IM_ASSERT(Glyphs.Size < 0xFFFF); // -1 is reserved
+    IM_ASSERT(Glyphs.Size < 0xFFFE); // -1 and -2 are reserved
+    LayoutCache.Clear();
     IndexAdvanceX.clear();
     IndexLookup.clear();
     GrowIndex(max_codepoint + 1);
@@ -2152,6 +2857,10 @@ void ImFont::BuildLookupTable()
         IndexLookup[codepoint] = (unsigned short)i;
     }
 
+    // With a dynamic atlas the remaining glyphs are rasterized by FindGlyph() when first used. Their advances are known right away so text measurement doesn't change.
+    if (ContainerAtlas && ContainerAtlas->DynamicBuildData)
+        ImFontAtlasBuildDynamicRegisterGlyphs(ContainerAtlas, this);
+
     // Create a glyph to handle TAB
     // FIXME: Needs proper TAB handling but it needs to be contextualized (or we could arbitrary say that each string starts at "column 0" ?)
     if (FindGlyph((unsigned short)' '))
@@ -2169,7 +2878,7 @@ void ImFont::BuildLookupTable()
     FallbackGlyph = NULL;
     FallbackGlyph = FindGlyph(FallbackChar);
     FallbackAdvanceX = FallbackGlyph ? FallbackGlyph->AdvanceX : 0.0f;
-    for (int i = 0; i < max_codepoint + 1; i++)
+    for (int i = 0; i < IndexAdvanceX.Size; i++)
         if (IndexAdvanceX[i] < 0.0f)
             IndexAdvanceX[i] = FallbackAdvanceX;
 }
@@ -2221,6 +2930,7 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
     if (src >= index_size && dst >= index_size) // both 'dst' and 'src' don't exist -> no-op
         return;
 
+    LayoutCache.Clear();
     GrowIndex(dst + 1);
     IndexLookup[dst] = (src < index_size) ? IndexLookup.Data[src] : (unsigned short)-1;
     IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
@@ -2231,12 +2941,234 @@ const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
     if (c < IndexLookup.Size)
     {
         const unsigned short i = IndexLookup[c];
+        if (i == FONT_GLYPH_INDEX_PENDING)
+            return ImFontAtlasBuildDynamicGlyph(ContainerAtlas, const_cast<ImFont*>(this), c);
         if (i != (unsigned short)-1)
             return &Glyphs.Data[i];
     }
     return FallbackGlyph;
 }
 
+//-----------------------------------------------------------------------------
+// ImFontLayoutCache
+//-----------------------------------------------------------------------------
+
+static const int FONT_LAYOUT_CACHE_MAX_TEXT_LEN = 512;
+static const int FONT_LAYOUT_CACHE_MAX_ENTRIES  = 1024;
+static const int FONT_LAYOUT_CACHE_MAX_QUADS    = 32 * 1024;
+
+void ImFontLayoutCache::Clear()
+{
+    Map.Clear();
+    Entries.clear();
+    Text.clear();
+    Quads.clear();
+    memset(Seen, 0, sizeof(Seen));
+    Stale = false;
+}
+
+// Word at a time: this runs for every label, CRC32 (ImHash) would cost about as much as measuring the text
+static ImU32 ImFontLayoutCacheHash(const char* data, int data_size, ImU32 seed)
+{
+    ImU64 h = seed ^ ((ImU64)data_size * 0x9E3779B97F4A7C15ULL);
+    for (; data_size >= 8; data += 8, data_size -= 8)
+    {
+        ImU64 k;
+        memcpy(&k, data, 8);
+        h = (h ^ (k * 0x87C37B91114253D5ULL)) * 0x4CF5AD432745937FULL;
+        h ^= h >> 31;
+    }
+    ImU64 k = 0;
+    memcpy(&k, data, (size_t)data_size);
+    h = (h ^ (k * 0x87C37B91114253D5ULL)) * 0x4CF5AD432745937FULL;
+    h ^= h >> 29;
+    return (ImU32)(h ^ (h >> 32));
+}
+
+// Returns NULL for strings that aren't cached (yet)
+static ImFontLayoutCache::Entry* ImFontLayoutCacheFind(ImFontLayoutCache& cache, float size, const char* text_begin, const char* text_end)
+{
+    const int text_len = (int)(text_end - text_begin);
+    if (text_len <= 0 || text_len > FONT_LAYOUT_CACHE_MAX_TEXT_LEN)
+        return NULL;
+    if (cache.Stale)
+        cache.Clear();
+
+    ImU32 size_bits;
+    memcpy(&size_bits, &size, sizeof(size_bits));
+    const ImGuiID hash = ImFontLayoutCacheHash(text_begin, text_len, size_bits);
+    if (int entry_idx = cache.Map.GetInt(hash, 0))
+    {
+        ImFontLayoutCache::Entry& entry = cache.Entries[entry_idx - 1];
+        if (entry.Size == size && entry.TextLen == text_len && memcmp(cache.Text.Data + entry.TextOffset, text_begin, (size_t)text_len) == 0)
+            return &entry;
+        return NULL; // Hash collision, not worth handling
+    }
+
+    ImGuiID& seen = cache.Seen[hash % IM_ARRAYSIZE(cache.Seen)];
+    if (seen != hash)
+    {
+        seen = hash;
+        return NULL;
+    }
+
+    // Start over once full, entries are cheap to rebuild
+    if (cache.Entries.Size >= FONT_LAYOUT_CACHE_MAX_ENTRIES || cache.Quads.Size + text_len > FONT_LAYOUT_CACHE_MAX_QUADS)
+        cache.Clear();
+    ImFontLayoutCache::Entry entry;
+    entry.Size = size;
+    entry.TextOffset = cache.Text.Size;
+    entry.TextLen = text_len;
+    entry.TextSize = ImVec2(-1.0f, 0.0f);
+    entry.QuadOffset = 0;
+    entry.QuadCount = -1;
+    entry.GlyphCount = 0;
+    entry.Scale = entry.LineHeight = 0.0f;
+    cache.Text.resize(cache.Text.Size + text_len);
+    memcpy(cache.Text.Data + entry.TextOffset, text_begin, (size_t)text_len);
+    cache.Entries.push_back(entry);
+    cache.Map.SetInt(hash, cache.Entries.Size);
+    return &cache.Entries.back();
+}
+
+// Same walk as RenderText() without word-wrapping or clipping, recording what moves the pen instead of its positions
+static void ImFontLayoutCacheBuildQuads(const ImFont* font, ImFontLayoutCache& cache, ImFontLayoutCache::Entry& entry, float size, const char* text_begin, const char* text_end)
+{
+    entry.Scale = size / font->FontSize;
+    entry.LineHeight = font->FontSize * entry.Scale;
+    entry.QuadOffset = cache.Quads.Size;
+    entry.GlyphCount = 0;
+    const char* s = text_begin;
+    while (s < text_end)
+    {
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            if (c == 0) // Malformed UTF-8?
+                break;
+        }
+
+        ImFontLayoutCache::Quad q = ImFontLayoutCache::Quad();
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                q.Kind = ImFontLayoutCache::QuadKind_NewLine;
+                cache.Quads.push_back(q);
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        const ImFontGlyph* glyph = font->FindGlyph((unsigned short)c);
+        if (!glyph)
+            continue;
+        q.AdvanceX = glyph->AdvanceX;
+        if (c != ' ' && c != '\t')
+        {
+            q.Kind = ImFontLayoutCache::QuadKind_Glyph;
+            q.X0 = glyph->X0; q.Y0 = glyph->Y0;
+            q.X1 = glyph->X1; q.Y1 = glyph->Y1;
+            q.U0 = glyph->U0; q.V0 = glyph->V0;
+            q.U1 = glyph->U1; q.V1 = glyph->V1;
+            entry.GlyphCount++;
+        }
+        else
+        {
+            q.Kind = ImFontLayoutCache::QuadKind_Blank;
+        }
+        cache.Quads.push_back(q);
+    }
+    entry.QuadCount = cache.Quads.Size - entry.QuadOffset;
+}
+
+// Returns false when some of the text would be culled or clipped: the regular path handles that
+// The pen math is written as in RenderText(), additions from the text position in the same order, so both paths round alike.
+static bool ImFontLayoutCacheRender(const ImFontLayoutCache& cache, const ImFontLayoutCache::Entry& entry, ImDrawList* draw_list, const ImVec2& pos, ImU32 col, const ImVec4& clip_rect, bool cpu_fine_clip)
+{
+    if (pos.y < clip_rect.y) // RenderText() would skip lines
+        return false;
+    if (entry.GlyphCount == 0)
+        return true;
+
+    const float scale = entry.Scale;
+    const ImFontLayoutCache::Quad* quads = cache.Quads.Data + entry.QuadOffset;
+    const ImFontLayoutCache::Quad* quads_end = quads + entry.QuadCount;
+    float x = pos.x;
+    float y = pos.y;
+    for (const ImFontLayoutCache::Quad* q = quads; q < quads_end; q++)
+    {
+        if (q->Kind == ImFontLayoutCache::QuadKind_NewLine)
+        {
+            x = pos.x;
+            y += entry.LineHeight;
+            if (y > clip_rect.w)
+                return false;
+            continue;
+        }
+        if (q->Kind == ImFontLayoutCache::QuadKind_Glyph)
+        {
+            const float x1 = x + q->X0 * scale;
+            const float x2 = x + q->X1 * scale;
+            if (x1 > clip_rect.z || x2 < clip_rect.x)
+                return false;
+            if (cpu_fine_clip)
+            {
+                const float y1 = y + q->Y0 * scale;
+                const float y2 = y + q->Y1 * scale;
+                if (x1 < clip_rect.x || x2 > clip_rect.z || y1 < clip_rect.y || y2 > clip_rect.w || y1 >= y2)
+                    return false;
+            }
+        }
+        const float char_width = q->AdvanceX * scale;
+        x += char_width;
+    }
+
+    draw_list->PrimReserve(entry.GlyphCount * 6, entry.GlyphCount * 4);
+    ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+    ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
+    unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
+    x = pos.x;
+    y = pos.y;
+    for (const ImFontLayoutCache::Quad* q = quads; q < quads_end; q++)
+    {
+        if (q->Kind == ImFontLayoutCache::QuadKind_NewLine)
+        {
+            x = pos.x;
+            y += entry.LineHeight;
+            continue;
+        }
+        if (q->Kind == ImFontLayoutCache::QuadKind_Glyph)
+        {
+            const float x1 = x + q->X0 * scale;
+            const float x2 = x + q->X1 * scale;
+            const float y1 = y + q->Y0 * scale;
+            const float y2 = y + q->Y1 * scale;
+            idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+            idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
+            vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = q->U0; vtx_write[0].uv.y = q->V0;
+            vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = q->U1; vtx_write[1].uv.y = q->V0;
+            vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = q->U1; vtx_write[2].uv.y = q->V1;
+            vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = q->U0; vtx_write[3].uv.y = q->V1;
+            vtx_write += 4;
+            vtx_current_idx += 4;
+            idx_write += 6;
+        }
+        const float char_width = q->AdvanceX * scale;
+        x += char_width;
+    }
+    draw_list->_VtxWritePtr = vtx_write;
+    draw_list->_IdxWritePtr = idx_write;
+    draw_list->_VtxCurrentIdx = vtx_current_idx;
+    return true;
+}
+
 const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
 {
     // Simple word-wrapping for English, not full-featured. Please submit failing cases!
@@ -2341,6 +3273,17 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // FIXME-OPT: Need to avoid this.
 
+    if (max_width == FLT_MAX && wrap_width <= 0.0f && remaining == NULL)
+        if (ImFontLayoutCache::Entry* entry = ImFontLayoutCacheFind(LayoutCache, size, text_begin, text_end))
+        {
+            if (entry->TextSize.x < 0.0f)
+            {
+                const char* text_remaining; // Also bypasses the cache
+                entry->TextSize = CalcTextSizeA(size, max_width, 0.0f, text_begin, text_end, &text_remaining);
+            }
+            return entry->TextSize;
+        }
+
     const float line_height = size;
     const float scale = size / FontSize;
 
@@ -2349,6 +3292,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
 
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    const float* ascii_advances = (IndexAdvanceX.Size >= 128) ? IndexAdvanceX.Data : NULL;
 
     const char* s = text_begin;
     while (s < text_end)
@@ -2381,6 +3325,31 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Printable ASCII runs need no decoding, control characters handling or index bounds checks
+        if (!word_wrap_enabled && ascii_advances)
+        {
+            const char* run_end = ImTextSkipPrintableAscii(s, text_end);
+            if (max_width == FLT_MAX)
+            {
+                for (; s < run_end; s++)
+                    line_width += ascii_advances[(unsigned char)*s] * scale;
+            }
+            else
+            {
+                for (; s < run_end; s++)
+                {
+                    const float char_width = ascii_advances[(unsigned char)*s] * scale;
+                    if (line_width + char_width >= max_width)
+                        break;
+                    line_width += char_width;
+                }
+                if (s < run_end)
+                    break;
+            }
+            if (s == text_end)
+                break;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -2457,6 +3426,15 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     if (y > clip_rect.w)
         return;
 
+    if (wrap_width <= 0.0f)
+        if (ImFontLayoutCache::Entry* entry = ImFontLayoutCacheFind(LayoutCache, size, text_begin, text_end))
+        {
+            if (entry->QuadCount < 0)
+                ImFontLayoutCacheBuildQuads(this, LayoutCache, *entry, size, text_begin, text_end);
+            if (ImFontLayoutCacheRender(LayoutCache, *entry, draw_list, pos, col, clip_rect, cpu_fine_clip))
+                return;
+        }
+
     const float scale = size / FontSize;
     const float line_height = FontSize * scale;
     const bool word_wrap_enabled = (wrap_width > 0.0f);
@@ -2478,6 +3456,8 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
     unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
 
+    // Everything before ascii_run_end is printable ASCII, skipping forward (wrapping, culled lines) keeps that true
+    const char* ascii_run_end = ImTextSkipPrintableAscii(s, text_end);
     while (s < text_end)
     {
         if (word_wrap_enabled)
@@ -2508,33 +3488,41 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
 
         // Decode and advance source
         unsigned int c = (unsigned int)*s;
-        if (c < 0x80)
+        if (s < ascii_run_end)
         {
             s += 1;
         }
         else
         {
-            s += ImTextCharFromUtf8(&c, s, text_end);
-            if (c == 0) // Malformed UTF-8?
-                break;
-        }
-
-        if (c < 32)
-        {
-            if (c == '\n')
+            if (c < 0x80)
             {
-                x = pos.x;
-                y += line_height;
-
-                if (y > clip_rect.w)
+                s += 1;
+            }
+            else
+            {
+                s += ImTextCharFromUtf8(&c, s, text_end);
+                if (c == 0) // Malformed UTF-8?
                     break;
-                if (!word_wrap_enabled && y + line_height < clip_rect.y)
-                    while (s < text_end && *s != '\n')  // Fast-forward to next line
-                        s++;
-                continue;
             }
-            if (c == '\r')
-                continue;
+
+            if (c < 32)
+            {
+                if (c == '\n')
+                {
+                    x = pos.x;
+                    y += line_height;
+
+                    if (y > clip_rect.w)
+                        break;
+                    if (!word_wrap_enabled && y + line_height < clip_rect.y)
+                        while (s < text_end && *s != '\n')  // Fast-forward to next line
+                            s++;
+                    continue;
+                }
+                if (c == '\r')
+                    continue;
+            }
+            ascii_run_end = ImTextSkipPrintableAscii(s, text_end);
         }
 
         float char_width = 0.0f;
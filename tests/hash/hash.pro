@@ -0,0 +1,5 @@
+TARGET = hash
+
+include(../tests.pri)
+
+SOURCES += main.cpp
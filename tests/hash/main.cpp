@@ -0,0 +1,146 @@
+// Checks ImHash() against the byte at a time CRC it replaced, then times both:
+//     hash                  CRC32, slice-by-8 tables
+//     hash_crc32c           CRC32C (IMGUI_USE_CRC32C_HASH), SSE4.2 or ARMv8 CRC instructions
+//     hash_crc32c_table     CRC32C, slice-by-8 tables (IMGUI_DISABLE_SIMD)
+// Each build is compared with the reference below using the same polynomial, so the hardware and table CRC32C builds give the same IDs.
+
+#include <VBE-Profiler/profiler/imgui.h>
+#include <VBE-Profiler/profiler/imgui_internal.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(IMGUI_USE_CRC32C_HASH) && !defined(IMGUI_DISABLE_SIMD) && defined(__SSE4_2__)
+static const char* Variant = "CRC32C, SSE4.2";
+#elif defined(IMGUI_USE_CRC32C_HASH) && !defined(IMGUI_DISABLE_SIMD) && defined(__ARM_FEATURE_CRC32)
+static const char* Variant = "CRC32C, ARMv8 CRC";
+#elif defined(IMGUI_USE_CRC32C_HASH)
+static const char* Variant = "CRC32C, slice-by-8";
+#else
+static const char* Variant = "CRC32, slice-by-8";
+#endif
+
+#ifdef IMGUI_USE_CRC32C_HASH
+static const ImU32 Polynomial = 0x82F63B78;
+static const ImU32 Check123456789 = 0xE3069283;
+#else
+static const ImU32 Polynomial = 0xEDB88320;
+static const ImU32 Check123456789 = 0xCBF43926;
+#endif
+
+// ImHash() as it was before slice-by-8, with the polynomial of this build
+static ImU32 RefHash(const void* data, int data_size, ImU32 seed)
+{
+    static ImU32 crc32_lut[256] = { 0 };
+    if (!crc32_lut[1])
+    {
+        for (ImU32 i = 0; i < 256; i++)
+        {
+            ImU32 crc = i;
+            for (ImU32 j = 0; j < 8; j++)
+                crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & Polynomial);
+            crc32_lut[i] = crc;
+        }
+    }
+
+    seed = ~seed;
+    ImU32 crc = seed;
+    const unsigned char* current = (const unsigned char*)data;
+
+    if (data_size > 0)
+    {
+        // Known size
+        while (data_size--)
+            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *current++];
+    }
+    else
+    {
+        // Zero-terminated string
+        while (unsigned char c = *current++)
+        {
+            if (c == '#' && current[0] == '#' && current[1] == '#')
+                crc = seed;
+            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
+        }
+    }
+    return ~crc;
+}
+
+static unsigned int Rand()
+{
+    static unsigned int state = 37;
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7FFF;
+}
+
+static int  Failures = 0;
+
+static void Check(bool ok, const char* what, const void* data, int data_size, ImU32 seed)
+{
+    if (!ok && Failures < 10)
+    {
+        if (data_size > 0)
+            printf("FAILED: %s (%d bytes, seed %08X)\n", what, data_size, seed);
+        else
+            printf("FAILED: %s (\"%s\", seed %08X)\n", what, (const char*)data, seed);
+    }
+    Failures += ok ? 0 : 1;
+}
+
+int main(int, char**)
+{
+    Check(ImHash("123456789", 9, 0) == Check123456789, "check value", "123456789", 9, 0);
+    Check(ImHash("123456789", 0, 0) == Check123456789, "check value", "123456789", 0, 0);
+
+    // Known sizes around the 4 and 8 byte steps, from every alignment, with and without seeds
+    static unsigned char buf[512 + 8];
+    for (int n = 0; n < (int)sizeof(buf); n++)
+        buf[n] = (unsigned char)Rand();
+    for (int data_size = 1; data_size <= 512; data_size++)
+        for (int offset = 0; offset < 8; offset++)
+        {
+            const ImU32 seed = (offset & 1) ? ((ImU32)Rand() << 17) ^ Rand() : 0;
+            Check(ImHash(buf + offset, data_size, seed) == RefHash(buf + offset, data_size, seed), "known size", buf + offset, data_size, seed);
+        }
+
+    // Zero-terminated strings, with "###" anywhere and runs of '#' of any length
+    static const char* const labels[] = { "", "#", "##", "###", "####", "#####", "######", "###a", "a###", "a####", "a###b", "a####b", "a###b###c", "a##b#c", "ab##c###", "Label##id", "Label###id", "Window###", "###Window###Id##" };
+    for (int n = 0; n < IM_ARRAYSIZE(labels); n++)
+        for (int s = 0; s < 3; s++)
+        {
+            const ImU32 seed = (s == 0) ? 0 : (s == 1) ? 0x9E3779B9 : 0xFFFFFFFF;
+            Check(ImHash(labels[n], 0, seed) == RefHash(labels[n], 0, seed), "string", labels[n], 0, seed);
+        }
+    static char str[300];
+    for (int n = 0; n < 200000; n++)
+    {
+        const int len = Rand() % 299;
+        for (int i = 0; i < len; i++)
+            str[i] = (Rand() % 4 == 0) ? '#' : (char)(1 + Rand() % 255);
+        str[len] = 0;
+        const ImU32 seed = (n & 1) ? ((ImU32)Rand() << 17) ^ Rand() : 0;
+        Check(ImHash(str, 0, seed) == RefHash(str, 0, seed), "random string", str, 0, seed);
+        if (len > 0)
+            Check(ImHash(str, len, seed) == RefHash(str, len, seed), "random data", str, len, seed);
+    }
+    printf("%s: %d failed\n", Variant, Failures);
+
+    // IDs of a typical UI (short labels hashed with the parent ID as seed) and large blocks
+    static const char* const ui_labels[] = { "Frame", "Update##42", "Render scene", "GameObject::draw", "Physics###phys", "A longer label for a tree node in the profiler" };
+    for (int k = 0; k < 2; k++)
+    {
+        ImU32 id = 0;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int n = 0; n < 2000000; n++)
+            id = k ? ImHash(ui_labels[n % IM_ARRAYSIZE(ui_labels)], 0, id) : RefHash(ui_labels[n % IM_ARRAYSIZE(ui_labels)], 0, id);
+        const double labels_ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / 2000000;
+        start = std::chrono::high_resolution_clock::now();
+        for (int n = 0; n < 20000; n++)
+            id = k ? ImHash(buf, 512, id) : RefHash(buf, 512, id);
+        const double block_ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / 20000;
+        printf("%-24s labels %6.1f ns, 512 byte blocks %7.1f ns (%.2f GB/s)  (%08X)\n", k ? "ImHash()" : "byte at a time", labels_ns, block_ns, 512 / block_ns, id);
+    }
+
+    ImGui::Shutdown();
+    return Failures ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+# hash built with IMGUI_USE_CRC32C_HASH and the CRC32C instructions of the host
+TARGET = hash_crc32c
+
+include(../tests.pri)
+
+DEFINES += IMGUI_USE_CRC32C_HASH
+
+# let ImHash use the CRC32C instructions
+contains(QMAKE_HOST.arch, "x86_64|i.86"): QMAKE_CXXFLAGS += -msse4.2
+contains(QMAKE_HOST.arch, "aarch64|armv8.*"): QMAKE_CXXFLAGS += -march=armv8-a+crc
+
+SOURCES += ../hash/main.cpp
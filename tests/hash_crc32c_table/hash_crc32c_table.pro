@@ -0,0 +1,8 @@
+# hash built with IMGUI_USE_CRC32C_HASH without the CRC32C instructions, so the slice-by-8 tables are used
+TARGET = hash_crc32c_table
+
+include(../tests.pri)
+
+DEFINES += IMGUI_USE_CRC32C_HASH IMGUI_DISABLE_SIMD
+
+SOURCES += ../hash/main.cpp
@@ -0,0 +1,151 @@
+// Checks that the SIMD edge/miter normals in AddPolyline()/AddConvexPolyFilled() produce the same vertices, bit for bit, as the scalar code, and
+// times both. The scalar build writes the reference draw data, the SIMD build compares against it:
+//     polyline_normals_scalar --write normals.bin
+//     polyline_normals --compare normals.bin
+// Without arguments it only prints the timings.
+
+#include <VBE-Profiler/profiler/imgui.h>
+#include <VBE-Profiler/profiler/imgui_internal.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(IMGUI_ENABLE_SSE2)
+static const char* Variant = "SSE2";
+#elif defined(IMGUI_ENABLE_NEON)
+static const char* Variant = "NEON";
+#else
+static const char* Variant = "scalar";
+#endif
+
+static const int ShapeCount = 4000;
+
+// Small deterministic generator so both builds draw the same shapes
+static unsigned int Rand()
+{
+    static unsigned int state = 12345;
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7FFF;
+}
+
+static void DrawShape(ImDrawList* draw_list, ImVec2* points)
+{
+    const int points_count = 2 + Rand() % 70;
+    for (int i = 0; i < points_count; i++)
+        points[i] = ImVec2((Rand() % 20000) / 13.0f, (Rand() % 20000) / 17.0f);
+    if (Rand() % 5 == 0)
+        points[1] = points[0]; // Zero length edge
+    const bool closed = (Rand() & 1) != 0;
+    const float thickness = (Rand() % 3 == 0) ? 1.0f : (Rand() % 50) / 10.0f;
+    switch (Rand() % 4)
+    {
+    case 0: draw_list->AddConvexPolyFilled(points, points_count, 0xFF00FF00, true); break;
+    case 1: draw_list->AddPolyline(points, points_count, 0xFFFFFFFF, closed, thickness, false); break;
+    default: draw_list->AddPolyline(points, points_count, 0xFFFFFFFF, closed, thickness, true); break;
+    }
+}
+
+static void AppendDrawData(std::vector<unsigned char>& out, const ImDrawList& draw_list)
+{
+    const unsigned char* vtx = (const unsigned char*)draw_list.VtxBuffer.Data;
+    const unsigned char* idx = (const unsigned char*)draw_list.IdxBuffer.Data;
+    const int sizes[2] = { draw_list.VtxBuffer.Size * (int)sizeof(ImDrawVert), draw_list.IdxBuffer.Size * (int)sizeof(ImDrawIdx) };
+    out.insert(out.end(), (const unsigned char*)sizes, (const unsigned char*)(sizes + 2));
+    out.insert(out.end(), vtx, vtx + sizes[0]);
+    out.insert(out.end(), idx, idx + sizes[1]);
+}
+
+static void ResetDrawList(ImDrawList& draw_list)
+{
+    draw_list.Clear();
+    draw_list.PushClipRectFullScreen();
+    draw_list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+}
+
+int main(int argc, char** argv)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280, 720);
+    io.IniFilename = NULL;
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::NewFrame();
+
+    ImDrawList draw_list;
+    static ImVec2 points[1000];
+    std::vector<unsigned char> shapes;
+    std::vector<size_t> shape_offsets;
+    for (int n = 0; n < ShapeCount; n++)
+    {
+        ResetDrawList(draw_list);
+        DrawShape(&draw_list, points);
+        shape_offsets.push_back(shapes.size());
+        AppendDrawData(shapes, draw_list);
+    }
+    shape_offsets.push_back(shapes.size());
+
+    int ret = 0;
+    if (argc == 3 && strcmp(argv[1], "--write") == 0)
+    {
+        FILE* f = fopen(argv[2], "wb");
+        if (!f || fwrite(shapes.data(), 1, shapes.size(), f) != shapes.size())
+            ret = 1;
+        if (f)
+            fclose(f);
+        printf("%s: wrote %d shapes, %d bytes\n", Variant, ShapeCount, (int)shapes.size());
+    }
+    else if (argc == 3 && strcmp(argv[1], "--compare") == 0)
+    {
+        std::vector<unsigned char> reference;
+        if (FILE* f = fopen(argv[2], "rb"))
+        {
+            unsigned char buf[4096];
+            for (size_t read; (read = fread(buf, 1, sizeof(buf), f)) > 0; )
+                reference.insert(reference.end(), buf, buf + read);
+            fclose(f);
+        }
+        int first_mismatch = -1;
+        for (int n = 0; n < ShapeCount && first_mismatch < 0; n++)
+        {
+            const size_t begin = shape_offsets[n], end = shape_offsets[n+1];
+            if (end > reference.size() || memcmp(shapes.data() + begin, reference.data() + begin, end - begin) != 0)
+                first_mismatch = n;
+        }
+        if (first_mismatch < 0 && reference.size() != shapes.size())
+            first_mismatch = ShapeCount;
+        if (first_mismatch >= 0)
+            printf("%s: FAILED, shape %d differs from the reference\n", Variant, first_mismatch);
+        else
+            printf("%s: %d shapes identical to the reference\n", Variant, ShapeCount);
+        ret = (first_mismatch >= 0) ? 1 : 0;
+    }
+
+    // Plot-like series: the case AddPolyline() spends most of its time on
+    for (int i = 0; i < 1000; i++)
+        points[i] = ImVec2(i * 0.35f, 30.0f + 20.0f * sinf(i * 0.1f));
+    const char* names[4] = { "AA 1px", "AA 3px", "non-AA 2px", "convex AA" };
+    const int repeats = 5000;
+    for (int mode = 0; mode < 4; mode++)
+    {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            ResetDrawList(draw_list);
+            if (mode == 0) draw_list.AddPolyline(points, 1000, 0xFFFFFFFF, false, 1.0f, true);
+            else if (mode == 1) draw_list.AddPolyline(points, 1000, 0xFFFFFFFF, false, 3.0f, true);
+            else if (mode == 2) draw_list.AddPolyline(points, 1000, 0xFFFFFFFF, false, 2.0f, false);
+            else draw_list.AddConvexPolyFilled(points, 1000, 0xFFFFFFFF, true);
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+        printf("%s: %-10s 1000 points %8.2f us\n", Variant, names[mode], us);
+    }
+
+    ImGui::Render();
+    ImGui::Shutdown();
+    return ret;
+}
@@ -0,0 +1,5 @@
+TARGET = polyline_normals
+
+include(../tests.pri)
+
+SOURCES += main.cpp
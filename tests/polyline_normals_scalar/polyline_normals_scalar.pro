@@ -0,0 +1,8 @@
+# polyline_normals built without the SSE2/NEON paths, the reference it is compared to
+TARGET = polyline_normals_scalar
+
+include(../tests.pri)
+
+DEFINES += IMGUI_DISABLE_SIMD
+
+SOURCES += ../polyline_normals/main.cpp
@@ -0,0 +1,450 @@
+// Checks ImGuiStorage against std::map with random operations, including the linear search done while Data was modified directly
+// (IndexedCount != Data.Size), and times it against the sorted storage it replaced at tree sizes seen in practice:
+//     storage
+// OldStorage below is ImGuiStorage as it was before the hash index: pairs sorted by key, binary searched and inserted in place.
+
+#include <VBE-Profiler/profiler/imgui.h>
+#include <VBE-Profiler/profiler/imgui_internal.h>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct OldStorage
+{
+    typedef ImGuiStorage::Pair Pair;
+    ImVector<Pair>      Data;
+
+    void                Clear() { Data.clear(); }
+    int                 GetInt(ImGuiID key, int default_val = 0) const;
+    void                SetInt(ImGuiID key, int val);
+    bool                GetBool(ImGuiID key, bool default_val = false) const;
+    void                SetBool(ImGuiID key, bool val);
+    float               GetFloat(ImGuiID key, float default_val = 0.0f) const;
+    void                SetFloat(ImGuiID key, float val);
+    void*               GetVoidPtr(ImGuiID key) const;
+    void                SetVoidPtr(ImGuiID key, void* val);
+    int*                GetIntRef(ImGuiID key, int default_val = 0);
+    bool*               GetBoolRef(ImGuiID key, bool default_val = false);
+    float*              GetFloatRef(ImGuiID key, float default_val = 0.0f);
+    void**              GetVoidPtrRef(ImGuiID key, void* default_val = NULL);
+    void                SetAllInt(int val);
+    void                BuildSortByKey();
+};
+
+// std::lower_bound but without the bullshit
+static ImVector<OldStorage::Pair>::iterator LowerBound(ImVector<OldStorage::Pair>& data, ImGuiID key)
+{
+    ImVector<OldStorage::Pair>::iterator first = data.begin();
+    ImVector<OldStorage::Pair>::iterator last = data.end();
+    size_t count = (size_t)(last - first);
+    while (count > 0)
+    {
+        size_t count2 = count >> 1;
+        ImVector<OldStorage::Pair>::iterator mid = first + count2;
+        if (mid->key < key)
+        {
+            first = ++mid;
+            count -= count2 + 1;
+        }
+        else
+        {
+            count = count2;
+        }
+    }
+    return first;
+}
+
+// For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
+void OldStorage::BuildSortByKey()
+{
+    struct StaticFunc 
+    { 
+        static int PairCompareByID(const void* lhs, const void* rhs) 
+        {
+            // We can't just do a subtraction because qsort uses signed integers and subtracting our ID doesn't play well with that.
+            if (((const Pair*)lhs)->key > ((const Pair*)rhs)->key) return +1;
+            if (((const Pair*)lhs)->key < ((const Pair*)rhs)->key) return -1;
+            return 0;
+        }
+    };
+    if (Data.Size > 1)
+        qsort(Data.Data, (size_t)Data.Size, sizeof(Pair), StaticFunc::PairCompareByID);
+}
+
+int OldStorage::GetInt(ImGuiID key, int default_val) const
+{
+    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<OldStorage::Pair>&>(Data), key);
+    if (it == Data.end() || it->key != key)
+        return default_val;
+    return it->val_i;
+}
+
+bool OldStorage::GetBool(ImGuiID key, bool default_val) const
+{
+    return GetInt(key, default_val ? 1 : 0) != 0;
+}
+
+float OldStorage::GetFloat(ImGuiID key, float default_val) const
+{
+    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<OldStorage::Pair>&>(Data), key);
+    if (it == Data.end() || it->key != key)
+        return default_val;
+    return it->val_f;
+}
+
+void* OldStorage::GetVoidPtr(ImGuiID key) const
+{
+    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<OldStorage::Pair>&>(Data), key);
+    if (it == Data.end() || it->key != key)
+        return NULL;
+    return it->val_p;
+}
+
+// References are only valid until a new value is added to the storage. Calling a Set***() function or a Get***Ref() function invalidates the pointer.
+int* OldStorage::GetIntRef(ImGuiID key, int default_val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+        it = Data.insert(it, Pair(key, default_val));
+    return &it->val_i;
+}
+
+bool* OldStorage::GetBoolRef(ImGuiID key, bool default_val)
+{
+    return (bool*)GetIntRef(key, default_val ? 1 : 0);
+}
+
+float* OldStorage::GetFloatRef(ImGuiID key, float default_val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+        it = Data.insert(it, Pair(key, default_val));
+    return &it->val_f;
+}
+
+void** OldStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+        it = Data.insert(it, Pair(key, default_val));
+    return &it->val_p;
+}
+
+// FIXME-OPT: Need a way to reuse the result of lower_bound when doing GetInt()/SetInt() - not too bad because it only happens on explicit interaction (maximum one a frame)
+void OldStorage::SetInt(ImGuiID key, int val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+    {
+        Data.insert(it, Pair(key, val));
+        return;
+    }
+    it->val_i = val;
+}
+
+void OldStorage::SetBool(ImGuiID key, bool val)
+{
+    SetInt(key, val ? 1 : 0);
+}
+
+void OldStorage::SetFloat(ImGuiID key, float val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+    {
+        Data.insert(it, Pair(key, val));
+        return;
+    }
+    it->val_f = val;
+}
+
+void OldStorage::SetVoidPtr(ImGuiID key, void* val)
+{
+    ImVector<Pair>::iterator it = LowerBound(Data, key);
+    if (it == Data.end() || it->key != key)
+    {
+        Data.insert(it, Pair(key, val));
+        return;
+    }
+    it->val_p = val;
+}
+
+
+void OldStorage::SetAllInt(int v)
+{
+    for (int i = 0; i < Data.Size; i++)
+        Data[i].val_i = v;
+}
+
+static unsigned int Rand()
+{
+    static unsigned int state = 38;
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7FFF;
+}
+
+// What the storage should hold for a key. Types are not stored by ImGuiStorage, so values are only read back as the type they were set with
+struct Expected
+{
+    enum Type { Type_Int, Type_Float, Type_Ptr };
+    Type    type;
+    int     val_i;
+    float   val_f;
+    void*   val_p;
+};
+
+static int  Failures = 0;
+
+static void Check(bool ok, const char* what, ImGuiID key)
+{
+    if (!ok && Failures < 10)
+        printf("FAILED: %s (key %08X)\n", what, key);
+    Failures += ok ? 0 : 1;
+}
+
+static void CheckAll(const ImGuiStorage& storage, const std::map<ImGuiID, Expected>& expected)
+{
+    Check(storage.Data.Size == (int)expected.size(), "pair count", 0);
+    for (std::map<ImGuiID, Expected>::const_iterator it = expected.begin(); it != expected.end(); ++it)
+    {
+        const Expected& e = it->second;
+        if (e.type == Expected::Type_Int)
+            Check(storage.GetInt(it->first, -1) == e.val_i, "GetInt() of every key", it->first);
+        else if (e.type == Expected::Type_Float)
+            Check(storage.GetFloat(it->first, -1.0f) == e.val_f, "GetFloat() of every key", it->first);
+        else
+            Check(storage.GetVoidPtr(it->first) == e.val_p, "GetVoidPtr() of every key", it->first);
+    }
+}
+
+// Keys are IDs, small sequential values as users store, or 0
+static ImGuiID RandomKey(int key_range)
+{
+    const unsigned int r = Rand();
+    if (r % 50 == 0)
+        return 0;
+    const int n = (int)(Rand() % key_range);
+    return (r % 3 == 0) ? (ImGuiID)n : ImHash(&n, sizeof(n), 0);
+}
+
+static void CheckRandomOperations(int key_range, int operations)
+{
+    ImGuiStorage storage;
+    std::map<ImGuiID, Expected> expected;
+    bool direct = false; // Data was modified directly since the last call that indexes it
+    for (int n = 0; n < operations; n++)
+    {
+        const ImGuiID key = RandomKey(key_range);
+        std::map<ImGuiID, Expected>::iterator it = expected.find(key);
+        const bool found = it != expected.end();
+        const int val_i = (int)Rand() - 16000;
+        const float val_f = val_i * 0.25f;
+        void* val_p = (void*)(intptr_t)(Rand() * 8 + 8);
+        const unsigned int op = Rand() % 100;
+        if (op < 15)
+        {
+            storage.SetInt(key, val_i);
+            Expected e = { Expected::Type_Int, val_i, 0.0f, NULL };
+            expected[key] = e;
+            direct = false;
+        }
+        else if (op < 20)
+        {
+            storage.SetFloat(key, val_f);
+            Expected e = { Expected::Type_Float, 0, val_f, NULL };
+            expected[key] = e;
+            direct = false;
+        }
+        else if (op < 25)
+        {
+            storage.SetVoidPtr(key, val_p);
+            Expected e = { Expected::Type_Ptr, 0, 0.0f, val_p };
+            expected[key] = e;
+            direct = false;
+        }
+        else if (op < 30)
+        {
+            storage.SetBool(key, (val_i & 1) != 0);
+            Expected e = { Expected::Type_Int, val_i & 1, 0.0f, NULL };
+            expected[key] = e;
+            direct = false;
+        }
+        else if (op < 45)
+        {
+            // Get***Ref() adds the default, then writes through the pointer
+            const Expected::Type type = found ? it->second.type : (Expected::Type)(Rand() % 3);
+            Expected& e = expected[key];
+            if (!found)
+            {
+                Expected d = { type, val_i, val_f, val_p };
+                e = d;
+            }
+            if (type == Expected::Type_Int)
+            {
+                int* p = storage.GetIntRef(key, val_i);
+                Check(*p == e.val_i, "GetIntRef()", key);
+                *p = e.val_i = val_i + 1;
+            }
+            else if (type == Expected::Type_Float)
+            {
+                float* p = storage.GetFloatRef(key, val_f);
+                Check(*p == e.val_f, "GetFloatRef()", key);
+                *p = e.val_f = val_f + 1.0f;
+            }
+            else
+            {
+                void** p = storage.GetVoidPtrRef(key, val_p);
+                Check(*p == e.val_p, "GetVoidPtrRef()", key);
+                *p = e.val_p = (char*)val_p + 8;
+            }
+            direct = false;
+        }
+        else if (op < 80)
+        {
+            if (!found)
+            {
+                Check(storage.GetInt(key, -7) == -7, "GetInt() of a missing key", key);
+                Check(storage.GetBool(key, true) == true, "GetBool() of a missing key", key);
+                Check(storage.GetFloat(key, 2.5f) == 2.5f, "GetFloat() of a missing key", key);
+                Check(storage.GetVoidPtr(key) == NULL, "GetVoidPtr() of a missing key", key);
+            }
+            else if (it->second.type == Expected::Type_Int)
+            {
+                Check(storage.GetInt(key, -7) == it->second.val_i, "GetInt()", key);
+                Check(storage.GetBool(key, false) == (it->second.val_i != 0), "GetBool()", key);
+            }
+            else if (it->second.type == Expected::Type_Float)
+            {
+                Check(storage.GetFloat(key, 2.5f) == it->second.val_f, "GetFloat()", key);
+            }
+            else
+            {
+                Check(storage.GetVoidPtr(key) == it->second.val_p, "GetVoidPtr()", key);
+            }
+        }
+        else if (op < 90)
+        {
+            // Append to Data directly: lookups have to fall back to a linear search until the next insertion or BuildSortByKey()
+            if (!found)
+            {
+                storage.Data.push_back(ImGuiStorage::Pair(key, val_i));
+                Expected e = { Expected::Type_Int, val_i, 0.0f, NULL };
+                expected[key] = e;
+                direct = true;
+            }
+            Check(!direct || storage.IndexedCount != storage.Data.Size, "linear search after Data.push_back()", key);
+        }
+        else if (op < 93)
+        {
+            // Remove the last pair directly: lookups fall back to a linear search too, until BuildSortByKey() is called as documented
+            if (storage.Data.Size > 0)
+            {
+                const ImGuiID removed_key = storage.Data.back().key;
+                expected.erase(removed_key);
+                storage.Data.pop_back();
+                Check(storage.GetVoidPtr(removed_key) == NULL && storage.GetInt(removed_key, -7) == -7, "linear search after Data.pop_back()", removed_key);
+                CheckAll(storage, expected);
+                storage.BuildSortByKey();
+                direct = false;
+            }
+        }
+        else if (op < 96)
+        {
+            storage.BuildSortByKey();
+            for (int i = 1; i < storage.Data.Size; i++)
+                Check(storage.Data[i - 1].key < storage.Data[i].key, "BuildSortByKey() order", storage.Data[i].key);
+            Check(storage.IndexedCount == storage.Data.Size, "BuildSortByKey() index", 0);
+            direct = false;
+        }
+        else if (op < 99)
+        {
+            storage.SetAllInt(val_i);
+            for (it = expected.begin(); it != expected.end(); ++it)
+            {
+                Expected e = { Expected::Type_Int, val_i, 0.0f, NULL };
+                it->second = e;
+            }
+        }
+        else if (Rand() % 20 == 0)
+        {
+            storage.Clear();
+            expected.clear();
+            direct = false;
+        }
+    }
+    CheckAll(storage, expected);
+
+    // Keys of a sorted Data filled directly, the way BuildSortByKey() is meant to be used
+    ImGuiStorage filled;
+    for (int n = 0; n < key_range; n++)
+        filled.Data.push_back(ImGuiStorage::Pair(ImHash(&n, sizeof(n), 0), n));
+    for (int n = 0; n < key_range; n += 7)
+        Check(filled.GetInt(ImHash(&n, sizeof(n), 0), -1) == n, "GetInt() before BuildSortByKey()", ImHash(&n, sizeof(n), 0));
+    filled.BuildSortByKey();
+    for (int n = 0; n < key_range; n++)
+        Check(filled.GetInt(ImHash(&n, sizeof(n), 0), -1) == n, "GetInt() after BuildSortByKey()", ImHash(&n, sizeof(n), 0));
+}
+
+static ImGuiID Ids[4096];
+
+// A tree expanded over 60 frames: nodes get their open state on first display, then it is read every frame
+template<typename STORAGE>
+static double TimeTreeFrames(int nodes_count)
+{
+    const int frames = 60;
+    const int repeats = 20000 / nodes_count + 1;
+    int sum = 0;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        STORAGE storage;
+        for (int f = 0; f < frames; f++)
+        {
+            const int visible = nodes_count * (f + 1) / frames;
+            for (int n = 0; n < visible; n++)
+                sum += *storage.GetIntRef(Ids[n], n & 1);
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+    return sum == 42 ? ms + 1.0 : ms;
+}
+
+// Lookups only, in a fully built storage
+template<typename STORAGE>
+static double TimeLookups(int nodes_count)
+{
+    STORAGE storage;
+    for (int n = 0; n < nodes_count; n++)
+        storage.SetInt(Ids[n], n);
+    const int lookups = 4000000;
+    int sum = 0;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (int n = 0, i = 0; n < lookups; n++, i = (i + 1 == nodes_count) ? 0 : i + 1)
+        sum += storage.GetInt(Ids[i] ^ (n & 1), -1);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / lookups;
+    return sum == 42 ? ns + 1.0 : ns;
+}
+
+int main(int, char**)
+{
+    const int key_ranges[] = { 8, 64, 1000, 20000 };
+    for (int n = 0; n < IM_ARRAYSIZE(key_ranges); n++)
+        CheckRandomOperations(key_ranges[n], 200000);
+    printf("Random operations: %d failed\n", Failures);
+
+    for (int n = 0; n < IM_ARRAYSIZE(Ids); n++)
+        Ids[n] = ImHash(&n, sizeof(n), 1234);
+    printf("nodes   tree over 60 frames (sorted / hashed)        lookup, half missing (sorted / hashed)\n");
+    for (int nodes_count = 16; nodes_count <= IM_ARRAYSIZE(Ids); nodes_count *= 4)
+    {
+        const double old_frames = TimeTreeFrames<OldStorage>(nodes_count);
+        const double new_frames = TimeTreeFrames<ImGuiStorage>(nodes_count);
+        const double old_lookup = TimeLookups<OldStorage>(nodes_count);
+        const double new_lookup = TimeLookups<ImGuiStorage>(nodes_count);
+        printf("%5d   %8.3f ms / %8.3f ms (%5.1fx)            %6.1f ns / %6.1f ns (%4.1fx)\n", nodes_count, old_frames, new_frames, old_frames / new_frames, old_lookup, new_lookup, old_lookup / new_lookup);
+    }
+
+    ImGui::Shutdown();
+    return Failures ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+TARGET = storage
+
+include(../tests.pri)
+
+SOURCES += main.cpp
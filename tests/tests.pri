@@ -0,0 +1,20 @@
+QT       -= core gui
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+unix {
+    QMAKE_CXXFLAGS += -pthread
+    LIBS += -lpthread
+}
+
+# imconfig.h includes VBE's math header, nothing needs linking from VBE
+INCLUDEPATH += $$PWD/../include $$PWD/../src $$PWD/../../VBE/include
+
+# same flags as VBE-Profiler.pro
+QMAKE_CXXFLAGS += -std=c++0x -fno-exceptions -ffp-contract=off
+
+SOURCES += \
+    $$PWD/../src/VBE-Profiler/profiler/imgui.cpp \
+    $$PWD/../src/VBE-Profiler/profiler/imgui_draw.cpp
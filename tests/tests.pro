@@ -0,0 +1,13 @@
+# Standalone checks and benchmarks of the changes made to ImGui, built from
+# the ImGui sources without a window or GL context. Each program exits with
+# a non-zero status when a check fails, see the top of its main.cpp
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    hash \
+    hash_crc32c \
+    hash_crc32c_table \
+    polyline_normals \
+    polyline_normals_scalar \
+    storage \
+    text_ascii
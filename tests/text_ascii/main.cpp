@@ -0,0 +1,530 @@
+// Checks that the printable ASCII fast paths of the text functions (ImTextSkipPrintableAscii() and its callers) give the same results as
+// decoding every character, and times CalcTextSizeA() over a large log buffer against that decoder path:
+//     text_ascii
+// The reference functions below are CalcWordWrapPositionA()/CalcTextSizeA()/RenderText() as they were before the fast paths, decoding
+// each character with ImTextCharFromUtf8(). RenderText() results also go through the layout cache for strings drawn more than once.
+
+#include <VBE-Profiler/profiler/imgui.h>
+#include <VBE-Profiler/profiler/imgui_internal.h>
+#include <chrono>
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const char* RefCalcWordWrapPositionA(const ImFont* font, float scale, const char* text, const char* text_end, float wrap_width)
+{
+    // Simple word-wrapping for English, not full-featured. Please submit failing cases!
+    // FIXME: Much possible improvements (don't cut things like "word !", "word!!!" but cut within "word,,,,", more sensible support for punctuations, support for Unicode punctuations, etc.)
+
+    // For references, possible wrap point marked with ^
+    //  "aaa bbb, ccc,ddd. eee   fff. ggg!"
+    //      ^    ^    ^   ^   ^__    ^    ^
+
+    // List of hardcoded separators: .,;!?'"
+
+    // Skip extra blanks after a line returns (that includes not counting them in width computation)
+    // e.g. "Hello    world" --> "Hello" "World"
+
+    // Cut words that cannot possibly fit within one line.
+    // e.g.: "The tropical fish" with ~5 characters worth of width --> "The tr" "opical" "fish"
+
+    float line_width = 0.0f;
+    float word_width = 0.0f;
+    float blank_width = 0.0f;
+    wrap_width /= scale; // We work with unscaled widths to avoid scaling every characters
+
+    const char* word_end = text;
+    const char* prev_word_end = NULL;
+    bool inside_word = true;
+
+    const char* s = text;
+    while (s < text_end)
+    {
+        unsigned int c = (unsigned int)*s;
+        const char* next_s;
+        if (c < 0x80)
+            next_s = s + 1;
+        else
+            next_s = s + ImTextCharFromUtf8(&c, s, text_end);
+        if (c == 0)
+            break;
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                line_width = word_width = blank_width = 0.0f;
+                inside_word = true;
+                s = next_s;
+                continue;
+            }
+            if (c == '\r')
+            {
+                s = next_s;
+                continue;
+            }
+        }
+
+        const float char_width = ((int)c < font->IndexAdvanceX.Size ? font->IndexAdvanceX[(int)c] : font->FallbackAdvanceX);
+        if (ImCharIsSpace(c))
+        {
+            if (inside_word)
+            {
+                line_width += blank_width;
+                blank_width = 0.0f;
+                word_end = s;
+            }
+            blank_width += char_width;
+            inside_word = false;
+        }
+        else
+        {
+            word_width += char_width;
+            if (inside_word)
+            {
+                word_end = next_s;
+            }
+            else
+            {
+                prev_word_end = word_end;
+                line_width += word_width + blank_width;
+                word_width = blank_width = 0.0f;
+            }
+
+            // Allow wrapping after punctuation.
+            inside_word = !(c == '.' || c == ',' || c == ';' || c == '!' || c == '?' || c == '\"');
+        }
+
+        // We ignore blank width at the end of the line (they can be skipped)
+        if (line_width + word_width >= wrap_width)
+        {
+            // Words that cannot possibly fit within an entire line will be cut anywhere.
+            if (word_width < wrap_width)
+                s = prev_word_end ? prev_word_end : word_end;
+            break;
+        }
+
+        s = next_s;
+    }
+
+    return s;
+}
+
+static ImVec2 RefCalcTextSizeA(const ImFont* font, float size, float max_width, float wrap_width, const char* text_begin, const char* text_end, const char** remaining)
+{
+    if (!text_end)
+        text_end = text_begin + strlen(text_begin); // FIXME-OPT: Need to avoid this.
+
+    const float line_height = size;
+    const float scale = size / font->FontSize;
+
+    ImVec2 text_size = ImVec2(0,0);
+    float line_width = 0.0f;
+
+    const bool word_wrap_enabled = (wrap_width > 0.0f);
+    const char* word_wrap_eol = NULL;
+
+    const char* s = text_begin;
+    while (s < text_end)
+    {
+        if (word_wrap_enabled)
+        {
+            // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
+            if (!word_wrap_eol)
+            {
+                word_wrap_eol = RefCalcWordWrapPositionA(font, scale, s, text_end, wrap_width - line_width);
+                if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
+                    word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
+            }
+
+            if (s >= word_wrap_eol)
+            {
+                if (text_size.x < line_width)
+                    text_size.x = line_width;
+                text_size.y += line_height;
+                line_width = 0.0f;
+                word_wrap_eol = NULL;
+
+                // Wrapping skips upcoming blanks
+                while (s < text_end)
+                {
+                    const char c = *s;
+                    if (ImCharIsSpace(c)) { s++; } else if (c == '\n') { s++; break; } else { break; }
+                }
+                continue;
+            }
+        }
+
+        // Decode and advance source
+        const char* prev_s = s;
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            if (c == 0) // Malformed UTF-8?
+                break;
+        }
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                text_size.x = ImMax(text_size.x, line_width);
+                text_size.y += line_height;
+                line_width = 0.0f;
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        const float char_width = ((int)c < font->IndexAdvanceX.Size ? font->IndexAdvanceX[(int)c] : font->FallbackAdvanceX) * scale;
+        if (line_width + char_width >= max_width)
+        {
+            s = prev_s;
+            break;
+        }
+
+        line_width += char_width;
+    }
+
+    if (text_size.x < line_width)
+        text_size.x = line_width;
+
+    if (line_width > 0 || text_size.y == 0.0f)
+        text_size.y += line_height;
+
+    if (remaining)
+        *remaining = s;
+
+    return text_size;
+}
+
+static void RefRenderText(const ImFont* font, ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip)
+{
+    if (!text_end)
+        text_end = text_begin + strlen(text_begin); // ImGui functions generally already provides a valid text_end, so this is merely to handle direct calls.
+
+    // Align to be pixel perfect
+    pos.x = (float)(int)pos.x + font->DisplayOffset.x;
+    pos.y = (float)(int)pos.y + font->DisplayOffset.y;
+    float x = pos.x;
+    float y = pos.y;
+    if (y > clip_rect.w)
+        return;
+
+    const float scale = size / font->FontSize;
+    const float line_height = font->FontSize * scale;
+    const bool word_wrap_enabled = (wrap_width > 0.0f);
+    const char* word_wrap_eol = NULL;
+
+    // Skip non-visible lines
+    const char* s = text_begin;
+    if (!word_wrap_enabled && y + line_height < clip_rect.y)
+        while (s < text_end && *s != '\n')  // Fast-forward to next line
+            s++;
+
+    // Reserve vertices for remaining worse case (over-reserving is useful and easily amortized)
+    const int vtx_count_max = (int)(text_end - s) * 4;
+    const int idx_count_max = (int)(text_end - s) * 6;
+    const int idx_expected_size = draw_list->IdxBuffer.Size + idx_count_max;
+    draw_list->PrimReserve(idx_count_max, vtx_count_max);
+
+    ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+    ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
+    unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
+
+    while (s < text_end)
+    {
+        if (word_wrap_enabled)
+        {
+            // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
+            if (!word_wrap_eol)
+            {
+                word_wrap_eol = RefCalcWordWrapPositionA(font, scale, s, text_end, wrap_width - (x - pos.x));
+                if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
+                    word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
+            }
+
+            if (s >= word_wrap_eol)
+            {
+                x = pos.x;
+                y += line_height;
+                word_wrap_eol = NULL;
+
+                // Wrapping skips upcoming blanks
+                while (s < text_end)
+                {
+                    const char c = *s;
+                    if (ImCharIsSpace(c)) { s++; } else if (c == '\n') { s++; break; } else { break; }
+                }
+                continue;
+            }
+        }
+
+        // Decode and advance source
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            if (c == 0) // Malformed UTF-8?
+                break;
+        }
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                x = pos.x;
+                y += line_height;
+
+                if (y > clip_rect.w)
+                    break;
+                if (!word_wrap_enabled && y + line_height < clip_rect.y)
+                    while (s < text_end && *s != '\n')  // Fast-forward to next line
+                        s++;
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        float char_width = 0.0f;
+        if (const ImFontGlyph* glyph = font->FindGlyph((unsigned short)c))
+        {
+            char_width = glyph->AdvanceX * scale;
+
+            // Arbitrarily assume that both space and tabs are empty glyphs as an optimization
+            if (c != ' ' && c != '\t')
+            {
+                // We don't do a second finer clipping test on the Y axis as we've already skipped anything before clip_rect.y and exit once we pass clip_rect.w
+                float x1 = x + glyph->X0 * scale;
+                float x2 = x + glyph->X1 * scale;
+                float y1 = y + glyph->Y0 * scale;
+                float y2 = y + glyph->Y1 * scale;
+                if (x1 <= clip_rect.z && x2 >= clip_rect.x)
+                {
+                    // Render a character
+                    float u1 = glyph->U0;
+                    float v1 = glyph->V0;
+                    float u2 = glyph->U1;
+                    float v2 = glyph->V1;
+
+                    // CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
+                    if (cpu_fine_clip)
+                    {
+                        if (x1 < clip_rect.x)
+                        {
+                            u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
+                            x1 = clip_rect.x;
+                        }
+                        if (y1 < clip_rect.y)
+                        {
+                            v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
+                            y1 = clip_rect.y;
+                        }
+                        if (x2 > clip_rect.z)
+                        {
+                            u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
+                            x2 = clip_rect.z;
+                        }
+                        if (y2 > clip_rect.w)
+                        {
+                            v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
+                            y2 = clip_rect.w;
+                        }
+                        if (y1 >= y2)
+                        {
+                            x += char_width;
+                            continue;
+                        }
+                    }
+
+                    // We are NOT calling PrimRectUV() here because non-inlined causes too much overhead in a debug builds. Inlined here:
+                    {
+                        idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+                        idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
+                        vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
+                        vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
+                        vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
+                        vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
+                        vtx_write += 4;
+                        vtx_current_idx += 4;
+                        idx_write += 6;
+                    }
+                }
+            }
+        }
+
+        x += char_width;
+    }
+
+    // Give back unused vertices
+    draw_list->VtxBuffer.resize((int)(vtx_write - draw_list->VtxBuffer.Data));
+    draw_list->IdxBuffer.resize((int)(idx_write - draw_list->IdxBuffer.Data));
+    draw_list->CmdBuffer[draw_list->CmdBuffer.Size-1].ElemCount -= (idx_expected_size - draw_list->IdxBuffer.Size);
+    draw_list->_VtxWritePtr = vtx_write;
+    draw_list->_IdxWritePtr = idx_write;
+    draw_list->_VtxCurrentIdx = (unsigned int)draw_list->VtxBuffer.Size;
+}
+
+static unsigned int Rand()
+{
+    static unsigned int state = 2024;
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7FFF;
+}
+
+// Printable ASCII runs of every length around the 16/32 byte SIMD blocks, broken by UTF-8, control characters and malformed sequences
+static std::string RandomText()
+{
+    static const char* const breaks[] = { "\n", "\r", "\t", "\r\n", "\x01", "\x1F", "\x7F", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xC3", "\xE2\x82", "\x80", "\xFF", "\xE3\x80\x80" };
+    std::string text;
+    const int pieces = 1 + Rand() % 6;
+    for (int n = 0; n < pieces; n++)
+    {
+        const int run = Rand() % 70;
+        for (int i = 0; i < run; i++)
+            text += (char)(' ' + Rand() % 95);
+        if (Rand() % 4 != 0)
+            text += breaks[Rand() % IM_ARRAYSIZE(breaks)];
+    }
+    return text;
+}
+
+static bool SameDrawData(const ImDrawList& a, const ImDrawList& b)
+{
+    return a.VtxBuffer.Size == b.VtxBuffer.Size && a.IdxBuffer.Size == b.IdxBuffer.Size && a.CmdBuffer.back().ElemCount == b.CmdBuffer.back().ElemCount &&
+        memcmp(a.VtxBuffer.Data, b.VtxBuffer.Data, a.VtxBuffer.Size * sizeof(ImDrawVert)) == 0 &&
+        memcmp(a.IdxBuffer.Data, b.IdxBuffer.Data, a.IdxBuffer.Size * sizeof(ImDrawIdx)) == 0;
+}
+
+static void ResetDrawList(ImDrawList& draw_list)
+{
+    draw_list.Clear();
+    draw_list.PushClipRectFullScreen();
+    draw_list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+}
+
+int main(int, char**)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280, 720);
+    io.IniFilename = NULL;
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::NewFrame();
+    const ImFont* font = io.Fonts->Fonts[0];
+
+    int failures = 0;
+    int checks = 0;
+
+    // ImTextSkipPrintableAscii() from every start offset of a buffer with a single stop byte anywhere
+    {
+        char buf[100];
+        for (int stop = 0; stop <= (int)sizeof(buf); stop++)
+            for (int stop_char = 0; stop_char < 4; stop_char++)
+            {
+                memset(buf, 'a', sizeof(buf));
+                if (stop < (int)sizeof(buf))
+                    buf[stop] = "\n\x1F\x80\xFF"[stop_char];
+                for (int begin = 0; begin <= (int)sizeof(buf); begin++)
+                {
+                    const char* expected = buf + begin;
+                    while (expected < buf + sizeof(buf) && (signed char)*expected >= ' ')
+                        expected++;
+                    failures += (ImTextSkipPrintableAscii(buf + begin, buf + sizeof(buf)) != expected) ? 1 : 0;
+                    checks++;
+                }
+            }
+    }
+
+    // Sizes, wrap positions and draw data of random text. Every string is used three times so the layout cache is hit too
+    ImDrawList draw_list, ref_draw_list;
+    const float sizes[] = { 13.0f, 16.5f, 20.0f };
+    const float wrap_widths[] = { 0.0f, 37.5f, 200.0f };
+    const ImVec4 clip_rects[] = { ImVec4(0.0f, 0.0f, 1280.0f, 720.0f), ImVec4(30.0f, 14.0f, 160.0f, 60.0f) };
+    for (int n = 0; n < 3000; n++)
+    {
+        const std::string text = RandomText();
+        const char* text_begin = text.c_str();
+        const char* text_end = text_begin + text.size();
+        const float size = sizes[Rand() % IM_ARRAYSIZE(sizes)];
+        const float wrap_width = wrap_widths[Rand() % IM_ARRAYSIZE(wrap_widths)];
+        const float max_width = (Rand() % 3 == 0) ? 10.0f + Rand() % 300 : FLT_MAX;
+        const ImVec4& clip_rect = clip_rects[Rand() % IM_ARRAYSIZE(clip_rects)];
+        const ImVec2 pos(20.0f + (Rand() % 1000) / 7.0f, (Rand() % 500) / 9.0f);
+        const bool cpu_fine_clip = (Rand() & 1) != 0;
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+            const char* remaining = NULL;
+            const char* ref_remaining = NULL;
+            const ImVec2 text_size = font->CalcTextSizeA(size, max_width, wrap_width, text_begin, text_end, &remaining);
+            const ImVec2 ref_size = RefCalcTextSizeA(font, size, max_width, wrap_width, text_begin, text_end, &ref_remaining);
+            const ImVec2 cached_size = font->CalcTextSizeA(size, FLT_MAX, wrap_width, text_begin, text_end);
+            const ImVec2 ref_full_size = RefCalcTextSizeA(font, size, FLT_MAX, wrap_width, text_begin, text_end, NULL);
+            const float scale = size / font->FontSize;
+            const bool wrap_same = wrap_width <= 0.0f || font->CalcWordWrapPositionA(scale, text_begin, text_end, wrap_width) == RefCalcWordWrapPositionA(font, scale, text_begin, text_end, wrap_width);
+
+            ResetDrawList(draw_list);
+            ResetDrawList(ref_draw_list);
+            font->RenderText(&draw_list, size, pos, 0xFFFFFFFF, clip_rect, text_begin, text_end, wrap_width, cpu_fine_clip);
+            RefRenderText(font, &ref_draw_list, size, pos, 0xFFFFFFFF, clip_rect, text_begin, text_end, wrap_width, cpu_fine_clip);
+
+            const bool same = memcmp(&text_size, &ref_size, sizeof(ImVec2)) == 0 && remaining == ref_remaining &&
+                memcmp(&cached_size, &ref_full_size, sizeof(ImVec2)) == 0 && wrap_same && SameDrawData(draw_list, ref_draw_list);
+            if (!same && failures < 10)
+                printf("FAILED on text %d (size %.1f, wrap %.1f, max %.1f): size %.3f,%.3f vs %.3f,%.3f\n", n, size, wrap_width, max_width, text_size.x, text_size.y, ref_size.x, ref_size.y);
+            failures += same ? 0 : 1;
+            checks++;
+        }
+    }
+    printf("%d checks, %d failed\n", checks, failures);
+
+    // A log buffer: mostly ASCII lines of a few dozen characters, a few of them with UTF-8
+    std::string log;
+    for (int line = 0; log.size() < 4 * 1024 * 1024; line++)
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "[%08.3f] Frame %d: update %.3f ms, draw %.3f ms%s\n", line * 0.016f, line, (line % 97) * 0.031f, (line % 53) * 0.047f, (line % 50 == 0) ? " \xE2\x9A\xA0 budget" : "");
+        log += buf;
+    }
+    const char* log_begin = log.c_str();
+    const char* log_end = log_begin + log.size();
+    const int repeats = 10;
+    for (int wrapped = 0; wrapped < 2; wrapped++)
+    {
+        const float wrap_width = wrapped ? 300.0f : 0.0f;
+        ImVec2 size_fast, size_ref;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++)
+            size_fast = font->CalcTextSizeA(font->FontSize, FLT_MAX, wrap_width, log_begin, log_end);
+        const double fast_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++)
+            size_ref = RefCalcTextSizeA(font, font->FontSize, FLT_MAX, wrap_width, log_begin, log_end, NULL);
+        const double ref_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+        printf("CalcTextSizeA, %d KB log%s: %.2f ms, decoding every character %.2f ms (%.2fx)\n", (int)(log.size() / 1024), wrapped ? " wrapped at 300px" : "", fast_ms, ref_ms, ref_ms / fast_ms);
+        if (memcmp(&size_fast, &size_ref, sizeof(ImVec2)) != 0)
+        {
+            printf("FAILED: log sizes differ\n");
+            failures++;
+        }
+    }
+
+    ImGui::Render();
+    ImGui::Shutdown();
+    return failures ? 1 : 0;
+}
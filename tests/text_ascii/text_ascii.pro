@@ -0,0 +1,5 @@
+TARGET = text_ascii
+
+include(../tests.pri)
+
+SOURCES += main.cpp